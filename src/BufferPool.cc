@@ -0,0 +1,138 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "BufferPool.hh"
+
+#include <XrdOuc/XrdOucCRC.hh>
+
+#include <cstring>
+
+BufferPool &BufferPool::Instance() {
+	static BufferPool instance;
+	return instance;
+}
+
+std::vector<char> BufferPool::Acquire() {
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		if (!m_free.empty()) {
+			auto segment = std::move(m_free.back());
+			m_free.pop_back();
+			return segment;
+		}
+	}
+	std::vector<char> segment;
+	segment.resize(m_segment_size);
+	return segment;
+}
+
+void BufferPool::Release(std::vector<char> &&segment) {
+	if (segment.size() != m_segment_size) {
+		return;
+	}
+	std::lock_guard<std::mutex> lk(m_mutex);
+	if (m_free.size() < m_max_free) {
+		m_free.emplace_back(std::move(segment));
+	}
+}
+
+void SegmentedBuffer::append(std::string_view data) {
+	// Fold the new bytes into the running checksum while they are still
+	// warm in cache; XrdOucCRC uses the SSE4.2/ARMv8 CRC instructions
+	// when available.
+	m_crc32c = XrdOucCRC::Calc32C(data.data(), data.size(), m_crc32c);
+	while (!data.empty()) {
+		if (m_size == m_segments.size() * BufferPool::m_segment_size) {
+			m_segments.emplace_back(BufferPool::Instance().Acquire());
+		}
+		auto segment_used = m_size % BufferPool::m_segment_size;
+		auto to_copy = std::min(data.size(),
+								BufferPool::m_segment_size - segment_used);
+		memcpy(m_segments.back().data() + segment_used, data.data(), to_copy);
+		m_size += to_copy;
+		data.remove_prefix(to_copy);
+	}
+}
+
+size_t SegmentedBuffer::copyOut(char *dest, size_t offset, size_t size) const {
+	if (offset >= m_size) {
+		return 0;
+	}
+	size = std::min(size, m_size - offset);
+	auto remaining = size;
+	auto segment_idx = offset / BufferPool::m_segment_size;
+	auto segment_off = offset % BufferPool::m_segment_size;
+	while (remaining) {
+		const auto &segment = m_segments[segment_idx];
+		auto to_copy =
+			std::min(remaining, BufferPool::m_segment_size - segment_off);
+		memcpy(dest, segment.data() + segment_off, to_copy);
+		dest += to_copy;
+		remaining -= to_copy;
+		segment_idx++;
+		segment_off = 0;
+	}
+	return size;
+}
+
+void SegmentedBuffer::clear() {
+	for (auto &segment : m_segments) {
+		BufferPool::Instance().Release(std::move(segment));
+	}
+	m_segments.clear();
+	m_size = 0;
+	m_crc32c = 0;
+}
+
+CacheSlabPool &CacheSlabPool::Instance() {
+	static CacheSlabPool instance;
+	return instance;
+}
+
+std::atomic<size_t> CacheSlabPool::m_max_free_bytes{512 * 1024 * 1024};
+
+CacheSlabPool::Slab CacheSlabPool::Acquire() {
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		if (!m_free.empty()) {
+			auto slab = std::move(m_free.back());
+			m_free.pop_back();
+			return Slab(std::move(slab));
+		}
+	}
+	std::vector<char> slab;
+	slab.resize(m_slab_size);
+	return Slab(std::move(slab));
+}
+
+void CacheSlabPool::Release(std::vector<char> &&slab) {
+	if (slab.size() != m_slab_size) {
+		return;
+	}
+	std::lock_guard<std::mutex> lk(m_mutex);
+	if ((m_free.size() + 1) * m_slab_size <= m_max_free_bytes) {
+		m_free.emplace_back(std::move(slab));
+	}
+}
+
+void CacheSlabPool::Slab::Release() {
+	if (!m_data.empty()) {
+		CacheSlabPool::Instance().Release(std::move(m_data));
+		m_data.clear();
+	}
+}
@@ -0,0 +1,185 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// A process-wide pool of fixed-size buffer segments.
+//
+// Buffering a streamed upload in a single contiguous string forces repeated
+// reallocation (transiently doubling the resident memory per file); instead,
+// payloads are built from fixed-size segments which are recycled across file
+// handles, capping the allocator churn.
+class BufferPool {
+  public:
+	// Returns the singleton instance of the pool.
+	static BufferPool &Instance();
+
+	// Acquire a segment of m_segment_size bytes, reusing a previously
+	// released one when available.
+	std::vector<char> Acquire();
+
+	// Return a segment to the pool for reuse.  Segments beyond the pool's
+	// retention cap are simply freed.
+	void Release(std::vector<char> &&segment);
+
+	// Size of each pooled segment.
+	static constexpr size_t m_segment_size = 1024 * 1024;
+
+  private:
+	BufferPool() = default;
+	BufferPool(const BufferPool &) = delete;
+
+	// Maximum number of idle segments retained for reuse.
+	static constexpr size_t m_max_free = 128;
+
+	std::mutex m_mutex; // Mutex protecting the free list.
+	std::vector<std::vector<char>> m_free; // Idle segments available for reuse.
+};
+
+// A byte buffer composed of fixed-size segments drawn from the BufferPool.
+//
+// Appends fill the last segment before acquiring a new one, so every segment
+// except the final one is exactly BufferPool::m_segment_size bytes; this
+// makes random-access reads (as performed by the curl read callback) a
+// simple index computation with no coalescing copy.
+class SegmentedBuffer {
+  public:
+	SegmentedBuffer() = default;
+	SegmentedBuffer(const SegmentedBuffer &) = delete;
+	SegmentedBuffer &operator=(const SegmentedBuffer &) = delete;
+	SegmentedBuffer(SegmentedBuffer &&other)
+		: m_size(other.m_size), m_crc32c(other.m_crc32c),
+		  m_segments(std::move(other.m_segments)) {
+		other.m_size = 0;
+		other.m_crc32c = 0;
+	}
+	SegmentedBuffer &operator=(SegmentedBuffer &&other) {
+		clear();
+		m_size = other.m_size;
+		m_crc32c = other.m_crc32c;
+		m_segments = std::move(other.m_segments);
+		other.m_size = 0;
+		other.m_crc32c = 0;
+		return *this;
+	}
+	~SegmentedBuffer() { clear(); }
+
+	// Total number of bytes held by the buffer.
+	size_t size() const { return m_size; }
+
+	bool empty() const { return m_size == 0; }
+
+	// CRC32C of the buffer's contents, accumulated incrementally as data
+	// is appended; by the time a buffered upload part is dispatched, its
+	// checksum is already known at no extra pass over the payload.
+	uint32_t crc32c() const { return m_crc32c; }
+
+	// Append the given bytes to the end of the buffer.
+	void append(std::string_view data);
+
+	// Copy up to `size` bytes starting at byte `offset` into `dest`,
+	// returning the number of bytes copied.
+	size_t copyOut(char *dest, size_t offset, size_t size) const;
+
+	// Release all segments back to the pool, emptying the buffer.
+	void clear();
+
+  private:
+	size_t m_size{0}; // Total number of bytes held.
+	// Running CRC32C of the appended bytes; maintained by append() and
+	// reset by clear().
+	uint32_t m_crc32c{0};
+	std::deque<std::vector<char>> m_segments; // Segments backing the buffer.
+};
+
+// A process-wide pool of cache-entry-sized slabs.
+//
+// Each cache-entry download previously resized a per-file vector, so a
+// server with hundreds of open files continuously re-allocated (and
+// re-faulted) multi-megabyte buffers; instead, the cache entries borrow
+// a slab for the lifetime of a filled block and return it for reuse when
+// the entry is recycled or the file handle closes.
+class CacheSlabPool {
+  public:
+	// RAII handle for one borrowed slab; returns the storage to the pool
+	// when destroyed or released.
+	class Slab {
+	  public:
+		Slab() = default;
+		Slab(const Slab &) = delete;
+		Slab &operator=(const Slab &) = delete;
+		Slab(Slab &&other) : m_data(std::move(other.m_data)) {}
+		Slab &operator=(Slab &&other) {
+			Release();
+			m_data = std::move(other.m_data);
+			return *this;
+		}
+		~Slab() { Release(); }
+
+		// Pointer to the slab's m_slab_size bytes; nullptr when empty.
+		char *data() { return m_data.data(); }
+		const char *data() const { return m_data.data(); }
+
+		bool empty() const { return m_data.empty(); }
+
+		// Return the storage to the pool, emptying the handle.
+		void Release();
+
+	  private:
+		friend class CacheSlabPool;
+		explicit Slab(std::vector<char> &&data) : m_data(std::move(data)) {}
+
+		std::vector<char> m_data;
+	};
+
+	// Returns the singleton instance of the pool.
+	static CacheSlabPool &Instance();
+
+	// Acquire a slab of m_slab_size bytes, reusing a previously released
+	// one when available.
+	Slab Acquire();
+
+	// Cap, in bytes, on the idle slabs retained for reuse; configured to
+	// the same budget as the shared block cache.
+	static void SetMaxFreeBytes(size_t bytes) { m_max_free_bytes = bytes; }
+
+	// Size of each pooled slab; matches the read cache entry size.
+	static constexpr size_t m_slab_size = 2 * 1024 * 1024;
+
+  private:
+	CacheSlabPool() = default;
+	CacheSlabPool(const CacheSlabPool &) = delete;
+
+	// Return a slab's storage to the free list (or drop it once the
+	// retention budget is reached).
+	void Release(std::vector<char> &&slab);
+
+	// Budget, in bytes, for idle slabs kept on the free list.
+	static std::atomic<size_t> m_max_free_bytes;
+
+	std::mutex m_mutex; // Mutex protecting the free list.
+	std::vector<std::vector<char>> m_free; // Idle slabs available for reuse.
+};
@@ -24,19 +24,32 @@
 #include <XrdOuc/XrdOucCRC.hh>
 #include <XrdSys/XrdSysPageSize.hh>
 
+#include <poll.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <charconv>
+#include <chrono>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 using namespace XrdHTTPServer;
 
 thread_local std::vector<CURL *> HandlerQueue::m_handles;
 
-HandlerQueue::HandlerQueue() {
+unsigned CurlWorker::m_workers = 5;
+long CurlWorker::m_max_streams = 0;
+
+HandlerQueue::Lane::Lane() : m_slots(new Slot[m_capacity]) {
+	for (unsigned idx = 0; idx < m_capacity; idx++) {
+		m_slots[idx].m_sequence.store(idx, std::memory_order_relaxed);
+		m_slots[idx].m_handler = nullptr;
+	}
+
 	int filedes[2];
 	auto result = pipe(filedes);
 	if (result == -1) {
@@ -66,6 +79,44 @@ int dump_header(CURL *handle, curl_infotype type, char *data, size_t size,
 	return 0;
 }
 
+// Mutexes protecting the data pooled in the share object; one per lock
+// class libcurl may ask for.
+std::mutex g_share_locks[CURL_LOCK_DATA_LAST];
+
+void shareLock(CURL *, curl_lock_data data, curl_lock_access, void *) {
+	g_share_locks[data].lock();
+}
+
+void shareUnlock(CURL *, curl_lock_data data, void *) {
+	g_share_locks[data].unlock();
+}
+
+// Returns the process-wide share object installed on every easy handle.
+//
+// The worker threads each run their own multi-handle and recycle easy
+// handles per-thread, so without the share object DNS resolutions and TLS
+// session tickets are redone per thread -- and discarded entirely when a
+// handle finishes with an error and is destroyed.  Pooling them (and the
+// connection cache itself, where libcurl supports sharing it) keeps the
+// cold-start handshakes off the small-object latency path.
+CURLSH *GetShareHandle() {
+	static CURLSH *share = []() -> CURLSH * {
+		auto result = curl_share_init();
+		if (result == nullptr) {
+			return nullptr;
+		}
+		curl_share_setopt(result, CURLSHOPT_LOCKFUNC, shareLock);
+		curl_share_setopt(result, CURLSHOPT_UNLOCKFUNC, shareUnlock);
+		curl_share_setopt(result, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt(result, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if CURL_AT_LEAST_VERSION(7, 57, 0)
+		curl_share_setopt(result, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+		return result;
+	}();
+	return share;
+}
+
 } // namespace
 
 CURL *GetHandle(bool verbose) {
@@ -74,6 +125,11 @@ CURL *GetHandle(bool verbose) {
 		return result;
 	}
 
+	auto share = GetShareHandle();
+	if (share != nullptr) {
+		curl_easy_setopt(result, CURLOPT_SHARE, share);
+	}
+
 	curl_easy_setopt(result, CURLOPT_USERAGENT, "xrootd-s3/devel");
 	curl_easy_setopt(result, CURLOPT_DEBUGFUNCTION, dump_header);
 	if (verbose)
@@ -96,11 +152,66 @@ CURL *HandlerQueue::GetHandle() {
 
 void HandlerQueue::RecycleHandle(CURL *curl) { m_handles.push_back(curl); }
 
-void HandlerQueue::Produce(HTTPRequest *handler) {
-	std::unique_lock<std::mutex> lk{m_mutex};
-	m_cv.wait(lk, [&] { return m_ops.size() < m_max_pending_ops; });
+bool HandlerQueue::Lane::TryPush(HTTPRequest *handler) {
+	auto pos = m_tail.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = m_slots[pos & (m_capacity - 1)];
+		auto seq = slot.m_sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<ssize_t>(seq) - static_cast<ssize_t>(pos);
+		if (diff == 0) {
+			// The slot is free; try to claim the position.
+			if (m_tail.compare_exchange_weak(pos, pos + 1,
+											 std::memory_order_relaxed)) {
+				slot.m_handler = handler;
+				slot.m_sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// The slot still holds an entry a full lap behind us.
+			return false;
+		} else {
+			// Another producer claimed the position; reload and retry.
+			pos = m_tail.load(std::memory_order_relaxed);
+		}
+	}
+}
 
-	m_ops.push_back(handler);
+HTTPRequest *HandlerQueue::Lane::TryPop() {
+	auto pos = m_head.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = m_slots[pos & (m_capacity - 1)];
+		auto seq = slot.m_sequence.load(std::memory_order_acquire);
+		auto diff =
+			static_cast<ssize_t>(seq) - static_cast<ssize_t>(pos + 1);
+		if (diff == 0) {
+			// The slot holds a ready entry; try to claim the position.
+			if (m_head.compare_exchange_weak(pos, pos + 1,
+											 std::memory_order_relaxed)) {
+				auto result = slot.m_handler;
+				slot.m_handler = nullptr;
+				// Mark the slot free for the producer's next lap.
+				slot.m_sequence.store(pos + m_capacity,
+									  std::memory_order_release);
+				return result;
+			}
+		} else if (diff < 0) {
+			// The slot hasn't been filled; the ring is empty.
+			return nullptr;
+		} else {
+			// Another consumer claimed the position; reload and retry.
+			pos = m_head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void HandlerQueue::Lane::RingDoorbell() {
+	// Writes and drains strictly alternate on the doorbell flag, so the
+	// pipe holds at most one byte no matter how many operations are
+	// produced -- one wakeup syscall per idle-to-busy transition rather
+	// than one per operation.
+	if (m_doorbell.exchange(true)) {
+		return;
+	}
 	char ready[] = "1";
 	while (true) {
 		auto result = write(m_write_fd, ready, 1);
@@ -112,18 +223,12 @@ void HandlerQueue::Produce(HTTPRequest *handler) {
 		}
 		break;
 	}
-
-	lk.unlock();
-	m_cv.notify_one();
 }
 
-HTTPRequest *HandlerQueue::Consume() {
-	std::unique_lock<std::mutex> lk(m_mutex);
-	m_cv.wait(lk, [&] { return m_ops.size() > 0; });
-
-	auto result = std::move(m_ops.front());
-	m_ops.pop_front();
-
+void HandlerQueue::Lane::SilenceDoorbell() {
+	if (!m_doorbell.exchange(false)) {
+		return;
+	}
 	char ready[1];
 	while (true) {
 		auto result = read(m_read_fd, ready, 1);
@@ -135,37 +240,75 @@ HTTPRequest *HandlerQueue::Consume() {
 		}
 		break;
 	}
-
-	lk.unlock();
-	m_cv.notify_one();
-
-	return result;
 }
 
-HTTPRequest *HandlerQueue::TryConsume() {
-	std::unique_lock<std::mutex> lk(m_mutex);
-	if (m_ops.size() == 0) {
-		return nullptr;
+void HandlerQueue::Produce(HTTPRequest *handler) {
+	// A full lane applies the same backpressure the old bounded deque did
+	// -- but only to producers of the same priority class; the workers are
+	// actively draining, so simply retry until a slot frees up.
+	auto &lane = GetLane(handler->getLane());
+	while (!lane.TryPush(handler)) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 	}
+	lane.RingDoorbell();
+}
 
-	auto result = std::move(m_ops.front());
-	m_ops.pop_front();
-
-	char ready[1];
+HTTPRequest *HandlerQueue::Consume() {
 	while (true) {
-		auto result = read(m_read_fd, ready, 1);
-		if (result == -1) {
-			if (errno == EINTR) {
-				continue;
+		// Service the lanes strictly in priority order.
+		for (auto &lane : m_lanes) {
+			auto result = lane.TryPop();
+			if (result) {
+				return result;
+			}
+			// The lane looks empty; quiet its doorbell before sleeping,
+			// then re-check in case a producer slipped an entry in between.
+			lane.SilenceDoorbell();
+			if (!lane.Empty()) {
+				lane.RingDoorbell();
 			}
+		}
+		if (std::any_of(m_lanes.begin(), m_lanes.end(),
+						[](const Lane &lane) { return !lane.Empty(); })) {
+			continue;
+		}
+
+		std::array<struct pollfd, m_lane_count> fds;
+		for (unsigned idx = 0; idx < m_lane_count; idx++) {
+			fds[idx].fd = m_lanes[idx].m_read_fd;
+			fds[idx].events = POLLIN;
+			fds[idx].revents = 0;
+		}
+		// The timeout is simply defense-in-depth; the doorbell protocol
+		// should always wake us when an entry arrives.
+		auto rv = poll(fds.data(), fds.size(), 1000);
+		if (rv == -1 && errno != EINTR) {
 			throw std::runtime_error(strerror(errno));
 		}
-		break;
 	}
+}
 
-	lk.unlock();
-	m_cv.notify_one();
+HTTPRequest *HandlerQueue::TryConsume() {
+	for (unsigned idx = 0; idx < m_lane_count; idx++) {
+		auto result = TryConsume(static_cast<RequestLane>(idx));
+		if (result) {
+			return result;
+		}
+	}
+	return nullptr;
+}
 
+HTTPRequest *HandlerQueue::TryConsume(RequestLane which) {
+	auto &lane = GetLane(which);
+	auto result = lane.TryPop();
+	if (!result) {
+		// Quiet the doorbell now that the lane is empty; re-ring if a
+		// producer raced us.
+		lane.SilenceDoorbell();
+		if (!lane.Empty()) {
+			lane.RingDoorbell();
+		}
+	}
 	return result;
 }
 
@@ -194,26 +337,77 @@ void CurlWorker::Run() {
 	if (multi_handle == nullptr) {
 		throw std::runtime_error("Failed to create curl multi-handle");
 	}
+	// Keep enough warm connections cached to service a full complement of
+	// operations instead of closing them as transfers complete, and avoid
+	// stampeding a single endpoint with more connections than the worker
+	// can concurrently drive.
+	curl_multi_setopt(multi_handle, CURLMOPT_MAXCONNECTS,
+					  static_cast<long>(2 * m_max_ops));
+#if CURL_AT_LEAST_VERSION(7, 30, 0)
+	curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS,
+					  static_cast<long>(m_max_ops));
+#endif
+	// Multiplex concurrent requests over a single connection where the
+	// server speaks HTTP/2; metadata and small-read handles additionally
+	// opt in to waiting for an existing connection (CURLOPT_PIPEWAIT, set
+	// in SetupHandle), so thousands of small GETs and HEADs share a few
+	// connections instead of paying a handshake and a kernel socket each.
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+	curl_multi_setopt(multi_handle, CURLMOPT_PIPELINING,
+					  static_cast<long>(CURLPIPE_MULTIPLEX));
+#endif
+#if CURL_AT_LEAST_VERSION(7, 67, 0)
+	if (m_max_streams > 0) {
+		curl_multi_setopt(multi_handle, CURLMOPT_MAX_CONCURRENT_STREAMS,
+						  m_max_streams);
+	}
+#endif
 
 	int running_handles = 0;
 	time_t last_marker = time(NULL);
 	CURLMcode mres = CURLM_OK;
 
+	// Whether the previous pass through the loop saw a streaming request
+	// among the in-flight operations; when one is present, the poll timeout
+	// below must be short enough for the timeout scan to notice a stalled
+	// upload, as a handle paused waiting on its next chunk generates no
+	// socket activity of its own.
+	bool streaming_in_flight = false;
+
+	// Number of in-flight operations per priority lane.
+	std::array<unsigned, HandlerQueue::m_lane_count> lane_running{};
+
+	// Whether an operation of the given lane may currently be started: the
+	// metadata lane may use any slot of `m_max_ops`, small reads may not
+	// dip into the slots reserved for metadata, and bulk transfers may dip
+	// into neither reserve -- so an interactive operation always finds a
+	// free slot no matter how much bulk traffic is queued.
+	auto lane_admissible = [&](RequestLane lane) {
+		switch (lane) {
+		case RequestLane::Metadata:
+			return true;
+		case RequestLane::SmallRead:
+			return lane_running[1] + lane_running[2] + m_metadata_reserve <
+				   m_max_ops;
+		case RequestLane::Bulk:
+			return lane_running[2] + m_metadata_reserve + m_small_read_reserve <
+				   m_max_ops;
+		}
+		return true;
+	};
+
+	// The `curl_multi_wait` call in the event loop needs to be interrupted
+	// when additional work comes into one of the two queues (either the
+	// global queue or the per-worker unpause queue).  To do this, the queue
+	// lanes each write to a file descriptor when a new HTTP request is
+	// ready; we add these FDs to the list of FDs for libcurl to poll in
+	// order to trigger a wakeup.  The `Consume`/`TryConsume` methods will
+	// have a side-effect of reading from the pipe if a request is
+	// available.  The set is rebuilt each pass, as a lane of the global
+	// queue is only watched while the worker has the capacity to start an
+	// operation from it.
 	std::vector<struct curl_waitfd> waitfds;
-	waitfds.resize(2);
-	// The `curl_multi_wait` call in the event loop needs to be interrupted when
-	// additional work comes into one of the two queues (either the global queue
-	// or the per-worker unpause queue).  To do this, the queue objects will
-	// write to a file descriptor when a new HTTP request is ready; we add these
-	// FDs to the list of FDs for libcurl to poll in order to trigger a wakeup.
-	// The `Consume`/`TryConsume` methods will have a side-effect of reading
-	// from the pipe if a request is available.
-	waitfds[0].fd = queue.PollFD();
-	waitfds[0].events = CURL_WAIT_POLLIN;
-	waitfds[0].revents = 0;
-	waitfds[1].fd = m_unpause_queue->PollFD();
-	waitfds[1].events = CURL_WAIT_POLLIN;
-	waitfds[1].revents = 0;
+	waitfds.reserve(2 * HandlerQueue::m_lane_count);
 
 	while (true) {
 		while (running_handles < static_cast<int>(m_max_ops)) {
@@ -224,11 +418,28 @@ void CurlWorker::Run() {
 			op->ContinueHandle();
 		}
 		while (running_handles < static_cast<int>(m_max_ops)) {
-			auto op =
-				running_handles == 0 ? queue.Consume() : queue.TryConsume();
+			HTTPRequest *op = nullptr;
+			if (running_handles == 0) {
+				op = queue.Consume();
+			} else {
+				// Probe the lanes in priority order, skipping any lane
+				// whose slot reservation would be violated.
+				for (unsigned idx = 0; idx < HandlerQueue::m_lane_count;
+					 idx++) {
+					auto lane = static_cast<RequestLane>(idx);
+					if (!lane_admissible(lane)) {
+						continue;
+					}
+					op = queue.TryConsume(lane);
+					if (op) {
+						break;
+					}
+				}
+			}
 			if (!op) {
 				break;
 			}
+			auto op_lane = static_cast<unsigned>(op->getLane());
 			op->SetUnpauseQueue(m_unpause_queue);
 
 			auto curl = queue.GetHandle();
@@ -263,6 +474,7 @@ void CurlWorker::Run() {
 				continue;
 			}
 			running_handles += 1;
+			lane_running[op_lane] += 1;
 		}
 
 		// Maintain the periodic reporting of thread activity
@@ -278,8 +490,45 @@ void CurlWorker::Run() {
 			last_marker = now;
 		}
 
-		mres = curl_multi_wait(multi_handle, &waitfds[0], waitfds.size(), 50,
-							   nullptr);
+		// Wait for activity on the transfer sockets or the queue pipes; the
+		// queue objects write a byte to their pipe when a request is ready,
+		// so there is no need for a short poll timeout here.  The timeout is
+		// capped at the marker period to keep the periodic activity report
+		// above flowing when the worker is otherwise idle and, when a
+		// streaming upload is in flight, at a fraction of the stall timeout
+		// so the timeout scan below runs often enough to catch a stall.
+		long wait_ms = m_marker_period * 1000;
+		if (streaming_in_flight) {
+			auto stall_ms = static_cast<long>(
+				std::chrono::duration_cast<std::chrono::milliseconds>(
+					HTTPRequest::GetStallTimeout())
+					.count() /
+				3);
+			wait_ms = std::min(wait_ms, std::max(stall_ms, 1L));
+		}
+		waitfds.clear();
+		for (unsigned idx = 0; idx < HandlerQueue::m_lane_count; idx++) {
+			auto lane = static_cast<RequestLane>(idx);
+			struct curl_waitfd waitfd;
+			waitfd.events = CURL_WAIT_POLLIN;
+			waitfd.revents = 0;
+			waitfd.fd = m_unpause_queue->PollFD(lane);
+			waitfds.push_back(waitfd);
+			if (running_handles < static_cast<int>(m_max_ops) &&
+				lane_admissible(lane)) {
+				waitfd.fd = queue.PollFD(lane);
+				waitfds.push_back(waitfd);
+			}
+		}
+#if CURL_AT_LEAST_VERSION(7, 66, 0)
+		mres = curl_multi_poll(multi_handle, &waitfds[0], waitfds.size(),
+							   wait_ms, nullptr);
+#else
+		// Older libcurl returns immediately from a wait with no running
+		// handles instead of honoring the timeout; keep the short poll.
+		mres = curl_multi_wait(multi_handle, &waitfds[0], waitfds.size(),
+							   std::min(wait_ms, 50L), nullptr);
+#endif
 		if (mres != CURLM_OK) {
 			if (m_logger.getMsgMask() & LogMask::Warning) {
 				std::stringstream ss;
@@ -318,12 +567,16 @@ void CurlWorker::Run() {
 				}
 				auto &op = iter->second;
 				auto res = msg->data.result;
+				// Capture the lane before notifying; the owner may delete
+				// the operation as soon as it is signalled.
+				auto op_lane = static_cast<unsigned>(op->getLane());
 				m_logger.Log(LogMask::Dump, "Run",
 							 "Processing result from curl");
 				op->ProcessCurlResult(iter->first, res);
 				op->ReleaseHandle(iter->first);
 				op->Notify();
 				running_handles -= 1;
+				lane_running[op_lane] -= 1;
 				curl_multi_remove_handle(multi_handle, iter->first);
 				if (res == CURLE_OK) {
 					// If the handle was successful, then we can recycle it.
@@ -334,6 +587,20 @@ void CurlWorker::Run() {
 				m_op_map.erase(iter);
 			}
 		} while (msg);
+
+		// Scan the remaining in-flight operations for streaming uploads
+		// whose next chunk has not arrived within the stall timeout.  The
+		// scan is bounded by `m_max_ops` and touches only this worker's own
+		// operations, so no locking is involved; `Tick` resumes any stalled
+		// handle so its read callback can abort the transfer.
+		auto tick_time = std::chrono::steady_clock::now();
+		streaming_in_flight = false;
+		for (auto &map_entry : m_op_map) {
+			if (map_entry.second->isStreamingRequest()) {
+				streaming_in_flight = true;
+				map_entry.second->Tick(tick_time);
+			}
+		}
 	}
 
 	for (auto &map_entry : m_op_map) {
@@ -18,10 +18,9 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <deque>
+#include <array>
+#include <atomic>
 #include <memory>
-#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -34,34 +33,105 @@ class HTTPRequest;
 // Returns a newly-created curl handle (no internal caching)
 CURL *GetHandle(bool verbose);
 
+// Priority class of a queued operation.  Metadata operations (stat, list,
+// and the various small control requests) are scheduled ahead of small
+// reads, which in turn are scheduled ahead of bulk data transfers, so a
+// burst of bulk traffic cannot queue an interactive operation behind it.
+enum class RequestLane { Metadata = 0, SmallRead = 1, Bulk = 2 };
+
 /**
- * HandlerQueue is a deque of curl operations that need
+ * HandlerQueue is a bounded queue of curl operations that need
  * to be performed.  The object is thread safe and can
  * be waited on via poll().
  *
  * The fact that it's poll'able is necessary because the
  * multi-curl driver thread is based on polling FD's
+ *
+ * Internally, the queue is split into one lane per priority class, each a
+ * lock-free multi-producer/multi-consumer ring (per-slot sequence counters
+ * decide whether a slot is ready for a producer or a consumer), so the
+ * common produce/consume path costs a couple of atomic operations instead
+ * of a mutex handoff plus a pipe syscall per operation.  Each lane keeps
+ * its own wakeup-doorbell pipe for pollers -- at most one byte lives in a
+ * pipe at a time, written on the empty-to-nonempty transition and drained
+ * once the ring goes idle -- letting a consumer wait on exactly the lanes
+ * it currently has capacity to serve.  Backpressure is likewise per-lane:
+ * a full bulk lane delays only bulk producers.
  */
 class HandlerQueue {
   public:
-	HandlerQueue();
+	// Number of priority lanes in the queue.
+	static constexpr unsigned m_lane_count{3};
 
 	void Produce(HTTPRequest *handler);
 
 	HTTPRequest *Consume();
 	HTTPRequest *TryConsume();
 
-	int PollFD() const { return m_read_fd; }
+	// Pop the oldest handler from the given lane only; returns nullptr if
+	// that lane is empty.
+	HTTPRequest *TryConsume(RequestLane lane);
+
+	// The doorbell FD of the given lane; readable whenever the lane holds
+	// entries.
+	int PollFD(RequestLane lane) const {
+		return m_lanes[static_cast<unsigned>(lane)].m_read_fd;
+	}
 
 	CURL *GetHandle();
 	void RecycleHandle(CURL *);
 
   private:
-	std::deque<HTTPRequest *> m_ops;
+	// One slot of a ring.  The sequence counter encodes which side may
+	// use the slot next: it equals the slot's position when it's free for
+	// a producer and position + 1 once a handler is ready for a consumer.
+	struct Slot {
+		std::atomic<size_t> m_sequence;
+		HTTPRequest *m_handler;
+	};
+
+	// Capacity of each lane's ring; must be a power of two.  Also serves as
+	// the bound on pending operations in the lane, applying backpressure to
+	// its producers.
+	const static unsigned m_capacity{64};
+
+	// One priority lane: an independent ring with its own wakeup doorbell.
+	struct Lane {
+		Lane();
+
+		// Push the handler into the ring; returns false if the ring is full.
+		bool TryPush(HTTPRequest *handler);
+
+		// Pop the oldest handler from the ring; returns nullptr if it's
+		// empty.
+		HTTPRequest *TryPop();
+
+		// Whether the ring currently holds no entries.
+		bool Empty() const {
+			return m_head.load(std::memory_order_acquire) ==
+				   m_tail.load(std::memory_order_acquire);
+		}
+
+		// Ensure the wakeup byte is present in the doorbell pipe.
+		void RingDoorbell();
+
+		// Drain the wakeup byte, if present, once the ring has gone empty.
+		void SilenceDoorbell();
+
+		std::unique_ptr<Slot[]> m_slots;
+		std::atomic<size_t> m_head{0}; // Next position to consume.
+		std::atomic<size_t> m_tail{0}; // Next position to produce.
+		// Tracks whether the wakeup byte is in the pipe; transitions strictly
+		// alternate, so the pipe never holds more than one byte.
+		std::atomic<bool> m_doorbell{false};
+		int m_read_fd{-1};
+		int m_write_fd{-1};
+	};
+
+	Lane &GetLane(RequestLane lane) {
+		return m_lanes[static_cast<unsigned>(lane)];
+	}
+
+	std::array<Lane, m_lane_count> m_lanes;
 	thread_local static std::vector<CURL *> m_handles;
-	std::condition_variable m_cv;
-	std::mutex m_mutex;
-	const static unsigned m_max_pending_ops{20};
-	int m_read_fd{-1};
-	int m_write_fd{-1};
 };
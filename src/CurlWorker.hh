@@ -39,6 +39,19 @@ class CurlWorker {
 	static void RunStatic(CurlWorker *myself);
 	static unsigned GetPollThreads() { return m_workers; }
 
+	// Set the number of worker threads to launch.  Only effective if invoked
+	// before the first request initializes the thread pool.
+	static void SetPollThreads(unsigned threads) { m_workers = threads; }
+
+	// Set the maximum number of concurrent streams libcurl may multiplex
+	// over a single HTTP/2 connection; zero leaves libcurl's default.
+	// Only effective if invoked before the first request initializes the
+	// thread pool.
+	static void SetMaxConcurrentStreams(long streams) {
+		m_max_streams = streams;
+	}
+	static long GetMaxConcurrentStreams() { return m_max_streams; }
+
   private:
 	std::shared_ptr<HandlerQueue> m_queue;
 	std::shared_ptr<HandlerQueue>
@@ -47,7 +60,14 @@ class CurlWorker {
 	std::unordered_map<CURL *, HTTPRequest *> m_op_map;
 	XrdSysError &m_logger;
 
-	const static unsigned m_workers{5};
+	static unsigned m_workers;
+	static long m_max_streams;
 	const static unsigned m_max_ops{20};
 	const static unsigned m_marker_period{5};
+
+	// Slots of `m_max_ops` reserved for the metadata lane, and additionally
+	// for the metadata and small-read lanes together; bulk transfers may
+	// only occupy the slots outside both reserves.
+	const static unsigned m_metadata_reserve{4};
+	const static unsigned m_small_read_reserve{4};
 };
@@ -17,9 +17,11 @@
  ***************************************************************/
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <filesystem>
+#include <iomanip>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -30,9 +32,11 @@
 #include <curl/curl.h>
 #include <openssl/hmac.h>
 
+#include "BufferPool.hh"
 #include "CurlUtil.hh"
 #include "CurlWorker.hh"
 #include "HTTPCommands.hh"
+#include "TransferStats.hh"
 #include "logging.hh"
 #include "shortfile.hh"
 #include "stl_string_utils.hh"
@@ -45,6 +49,7 @@ bool HTTPRequest::m_workers_initialized = false;
 std::vector<CurlWorker *> HTTPRequest::m_workers;
 std::chrono::steady_clock::duration HTTPRequest::m_timeout_duration =
 	std::chrono::seconds(10);
+std::atomic<long> HTTPRequest::m_slow_threshold_ms{0};
 
 //
 // "This function gets called by libcurl as soon as there is data received
@@ -130,7 +135,7 @@ bool HTTPRequest::parseProtocol(const std::string &url, std::string &protocol) {
 	return true;
 }
 
-bool HTTPRequest::SendHTTPRequest(const std::string &payload) {
+bool HTTPRequest::SendHTTPRequest(const std::string &payload, bool blocking) {
 	if ((m_protocol != "http") && (m_protocol != "https")) {
 		errorCode = "E_INVALID_SERVICE_URL";
 		errorMessage = "Service URL not of a known protocol (http[s]).";
@@ -142,6 +147,10 @@ bool HTTPRequest::SendHTTPRequest(const std::string &payload) {
 
 	headers["Content-Type"] = "binary/octet-stream";
 
+	if (!blocking) {
+		return sendPreparedRequestNonblocking(hostUrl, payload, payload.size(),
+											  true);
+	}
 	return sendPreparedRequest(hostUrl, payload, payload.size(), true);
 }
 
@@ -277,7 +286,10 @@ size_t HTTPRequest::ReadCallback(char *buffer, size_t size, size_t n, void *v) {
 		return CURL_READFUNC_ABORT;
 	}
 
-	if (payload->sentSoFar == static_cast<off_t>(payload->data.size())) {
+	auto payload_size = payload->segments
+							? payload->segments->size()
+							: payload->data.size();
+	if (payload->sentSoFar == static_cast<off_t>(payload_size)) {
 		payload->sentSoFar = 0;
 		if (payload->final) {
 			return 0;
@@ -288,15 +300,20 @@ size_t HTTPRequest::ReadCallback(char *buffer, size_t size, size_t n, void *v) {
 	}
 
 	size_t request = size * n;
-	if (request > payload->data.size()) {
-		request = payload->data.size();
+	if (request > payload_size) {
+		request = payload_size;
 	}
 
-	if (payload->sentSoFar + request > payload->data.size()) {
-		request = payload->data.size() - payload->sentSoFar;
+	if (payload->sentSoFar + request > payload_size) {
+		request = payload_size - payload->sentSoFar;
 	}
 
-	memcpy(buffer, payload->data.data() + payload->sentSoFar, request);
+	if (payload->segments) {
+		// Walk the pooled segments directly; no coalescing copy is made.
+		payload->segments->copyOut(buffer, payload->sentSoFar, request);
+	} else {
+		memcpy(buffer, payload->data.data() + payload->sentSoFar, request);
+	}
 	payload->sentSoFar += request;
 
 	return request;
@@ -340,8 +357,10 @@ bool HTTPRequest::sendPreparedRequestNonblocking(const std::string &uri,
 	m_last_request = std::chrono::steady_clock::now();
 	m_final = final;
 	// Detect whether we were given an undersized buffer in non-streaming mode
+	auto provided_size =
+		m_payload_segments ? m_payload_segments->size() : payload.size();
 	if (!m_is_streaming && payload_size &&
-		payload_size != static_cast<off_t>(payload.size())) {
+		payload_size != static_cast<off_t>(provided_size)) {
 		errorCode = "E_LOGIC";
 		std::stringstream ss;
 		ss << "Logic error: given an undersized payload (have "
@@ -372,25 +391,36 @@ bool HTTPRequest::sendPreparedRequest(const std::string &uri,
 	return errorCode.empty();
 }
 
+bool HTTPRequest::WaitForCompletion() {
+	std::unique_lock<std::mutex> lk(m_mtx);
+	m_cv.wait(lk, [&] { return m_result_ready; });
+
+	return errorCode.empty();
+}
+
 void HTTPRequest::Tick(std::chrono::steady_clock::time_point now) {
 	if (!m_is_streaming) {
 		return;
 	}
-	if (now - m_last_request <= m_timeout_duration) {
+	// Once the final response has been processed there is nothing left to
+	// stall; the result is simply waiting to be harvested by the caller.
+	if (m_completed) {
 		return;
 	}
-
-	if (m_timeout) {
+	if (now - m_last_request.load(std::memory_order_relaxed) <=
+		m_timeout_duration) {
 		return;
 	}
-	m_timeout = true;
 
-	if (m_unpause_queue) {
-		std::unique_lock<std::mutex> lk(m_mtx);
-		m_result_ready = false;
-		m_unpause_queue->Produce(this);
-		m_cv.wait(lk, [&] { return m_result_ready; });
+	if (m_timeout.exchange(true)) {
+		return;
 	}
+
+	// We are running on the worker thread that owns the paused handle, so
+	// the handle can be resumed directly; the read callback will observe
+	// the timeout and abort the transfer, failing the request through the
+	// worker's normal completion processing.
+	ContinueHandle();
 }
 
 bool HTTPRequest::ReleaseHandle(CURL *curl) {
@@ -417,6 +447,9 @@ bool HTTPRequest::ReleaseHandle(CURL *curl) {
 	curl_easy_setopt(curl, CURLOPT_POST, 0);
 	curl_easy_setopt(curl, CURLOPT_UPLOAD, 0);
 	curl_easy_setopt(curl, CURLOPT_HEADER, 0);
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+	curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 0L);
+#endif
 	curl_easy_setopt(curl, CURLOPT_SSLCERT, nullptr);
 	curl_easy_setopt(curl, CURLOPT_SSLKEY, nullptr);
 
@@ -431,6 +464,7 @@ bool HTTPRequest::ContinueHandle() {
 	m_callback_payload->data = m_payload;
 	m_callback_payload->final = m_final;
 	m_callback_payload->sentSoFar = 0;
+	m_callback_payload->segments = m_payload_segments;
 	curl_easy_pause(m_curl_handle, CURLPAUSE_CONT);
 	return true;
 }
@@ -503,7 +537,8 @@ bool HTTPRequest::SetupHandle(CURL *curl) {
 		// and the offset of the data Here, we tell curl_easy_setopt to use the
 		// read_callback function to read the data from the payload
 		m_callback_payload = std::unique_ptr<HTTPRequest::Payload>(
-			new HTTPRequest::Payload{m_payload, 0, m_final, *this});
+			new HTTPRequest::Payload{m_payload, 0, m_final, *this,
+									 m_payload_segments});
 		rv = curl_easy_setopt(curl, CURLOPT_READDATA, m_callback_payload.get());
 		if (rv != CURLE_OK) {
 			this->errorCode = "E_CURL_LIB";
@@ -537,6 +572,20 @@ bool HTTPRequest::SetupHandle(CURL *curl) {
 		return false;
 	}
 
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+	if (getLane() != RequestLane::Bulk) {
+		// Prefer multiplexing a small operation onto an existing HTTP/2
+		// connection over opening another one; the wait for an in-progress
+		// handshake is far cheaper than performing a fresh one per request.
+		rv = curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+		if (rv != CURLE_OK) {
+			this->errorCode = "E_CURL_LIB";
+			this->errorMessage = "curl_easy_setopt( CURLOPT_PIPEWAIT ) failed.";
+			return false;
+		}
+	}
+#endif
+
 	if (includeResponseHeader) {
 		rv = curl_easy_setopt(curl, CURLOPT_HEADER, 1);
 		if (rv != CURLE_OK) {
@@ -698,6 +747,7 @@ bool HTTPRequest::Fail(const std::string &ecode, const std::string &emsg) {
 	errorCode = ecode;
 	errorMessage = emsg;
 
+	m_completed = true;
 	Notify();
 	return true;
 }
@@ -709,9 +759,65 @@ void HTTPRequest::Notify() {
 	m_cv.notify_one();
 }
 
+std::string HTTPRequest::getEndpointName() const {
+	auto authority = hostUrl.find("://");
+	if (authority == std::string::npos) {
+		return hostUrl;
+	}
+	auto path = hostUrl.find('/', authority + 3);
+	return hostUrl.substr(0, path);
+}
+
 HTTPRequest::CurlResult HTTPRequest::ProcessCurlResult(CURL *curl,
 													   CURLcode rv) {
 
+	m_completed = true;
+	{
+		// Record the completed attempt (each retry counts separately); a
+		// response code of zero indicates no response was received.
+		long code = 0;
+		if (rv == 0) {
+			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+		}
+		TransferStats::Instance().RecordRequest(getEndpointName(), code,
+												m_bytes_sent, m_bytes_recv);
+	}
+	{
+		// Harvest the per-phase timings from the completed handle so slow
+		// requests can be decomposed into DNS, TLS, time-to-first-byte,
+		// and transfer time after the fact.
+		TransferStats::RequestTiming timing;
+		curl_off_t speed{0};
+		curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &timing.m_namelookup);
+		curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &timing.m_appconnect);
+		curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME,
+						  &timing.m_starttransfer);
+		curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &timing.m_total);
+		if (curl_easy_getinfo(curl, CURLINFO_SPEED_DOWNLOAD_T, &speed) ==
+				CURLE_OK &&
+			speed > 0) {
+			timing.m_speed_download = speed;
+		}
+		if (curl_easy_getinfo(curl, CURLINFO_SPEED_UPLOAD_T, &speed) ==
+				CURLE_OK &&
+			speed > 0) {
+			timing.m_speed_upload = speed;
+		}
+		TransferStats::Instance().RecordRequestTiming(getEndpointName(),
+													  timing);
+		auto threshold = m_slow_threshold_ms.load(std::memory_order_relaxed);
+		if (threshold &&
+			timing.m_total * 1000 >= static_cast<double>(threshold)) {
+			std::ostringstream ss;
+			ss << "Slow request: " << httpVerb << " " << hostUrl << " took "
+			   << std::fixed << std::setprecision(3) << timing.m_total
+			   << "s (namelookup " << timing.m_namelookup << "s, appconnect "
+			   << timing.m_appconnect << "s, starttransfer "
+			   << timing.m_starttransfer << "s, retries " << m_retry_count
+			   << ")";
+			m_log.Log(LogMask::Warning, "SlowRequest", ss.str().c_str());
+		}
+	}
 	if (rv != 0) {
 		if (errorCode.empty()) {
 			errorCode = "E_CURL_IO";
@@ -781,6 +887,12 @@ bool HTTPUpload::SendRequest(const std::string &payload, off_t offset,
 	return SendHTTPRequest(payload);
 }
 
+bool HTTPUpload::SendRequest(const std::string_view payload, off_t payload_size,
+							 bool final) {
+	httpVerb = "PUT";
+	return sendPreparedRequest(hostUrl, payload, payload_size, final);
+}
+
 void HTTPRequest::Init(XrdSysError &log) {
 	if (!m_workers_initialized) {
 		for (unsigned idx = 0; idx < CurlWorker::GetPollThreads(); idx++) {
@@ -809,10 +921,14 @@ bool HTTPDownload::SendRequest(off_t offset, size_t size) {
 		headers["Range"] = range.c_str();
 		this->expectedResponseCode = 206;
 	}
+	if (size && m_buffer) {
+		m_buffer_view = std::string_view(m_buffer, size);
+	}
+	m_request_size = size;
 
 	httpVerb = "GET";
 	std::string noPayloadAllowed;
-	return SendHTTPRequest(noPayloadAllowed);
+	return SendHTTPRequest(noPayloadAllowed, IsBlocking());
 }
 
 // ---------------------------------------------------------------------------
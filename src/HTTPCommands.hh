@@ -18,8 +18,10 @@
 
 #pragma once
 
+#include "CurlUtil.hh"
 #include "TokenFile.hh"
 
+#include <atomic>
 #include <condition_variable>
 #include <map>
 #include <memory>
@@ -33,6 +35,7 @@
 class XrdSysError;
 class HandlerQueue;
 class CurlWorker;
+class SegmentedBuffer;
 
 class HTTPRequest {
 	friend class CurlWorker;
@@ -57,19 +60,33 @@ class HTTPRequest {
 
 	virtual bool parseProtocol(const std::string &url, std::string &protocol);
 
-	virtual bool SendHTTPRequest(const std::string &payload);
+	// Send the request to the HTTP server; when `blocking` is false, the
+	// request is handed to the curl worker pool and the caller must collect
+	// it via `WaitForCompletion` before inspecting the response.
+	virtual bool SendHTTPRequest(const std::string &payload,
+								 bool blocking = true);
 
 	unsigned long getResponseCode() const { return responseCode; }
 	const std::string &getErrorCode() const { return errorCode; }
 	const std::string &getErrorMessage() const { return errorMessage; }
 	const std::string &getResultString() const { return m_result; }
 
+	// Block until a request previously handed to the curl workers via the
+	// nonblocking send path has run to completion (successfully or not).
+	//
+	// Returns true if the request completed without error.
+	bool WaitForCompletion();
+
 	// State of the payload upload for the curl callbacks
 	struct Payload {
 		std::string_view data;
 		off_t sentSoFar{0};
 		bool final{true};
 		HTTPRequest &m_parent;
+		// When set, the payload bytes live in the segmented buffer instead
+		// of the contiguous `data` view; the read callback walks the
+		// segments directly without any coalescing copy.
+		const SegmentedBuffer *segments{nullptr};
 
 		void NotifyPaused(); // Notify the parent request the curl handle has
 							 // been paused
@@ -81,7 +98,13 @@ class HTTPRequest {
 	// context.
 	static void Init(XrdSysError &);
 
-	// Perform maintenance of the request.
+	// Perform timeout maintenance of the request.
+	//
+	// Invoked by the curl worker that owns the request's handle once per
+	// event-loop pass; if this is a streaming request that has not received
+	// a new chunk within the stall timeout, the request is marked as timed
+	// out and the paused handle is resumed so the read callback can abort
+	// the transfer through the normal completion path.
 	void Tick(std::chrono::steady_clock::time_point);
 
 	// Sets the duration after which an in-progress operation may be considered
@@ -95,7 +118,17 @@ class HTTPRequest {
 		return m_timeout_duration;
 	}
 
+	// Sets the total-time threshold at or above which a completed request
+	// logs its per-phase timing breakdown; zero disables the tracing.
+	static void SetSlowRequestThreshold(std::chrono::milliseconds threshold) {
+		m_slow_threshold_ms = threshold.count();
+	}
+
   protected:
+	// Largest read, in bytes, still scheduled in the small-read lane;
+	// larger transfers ride the bulk lane alongside the uploads.
+	static constexpr size_t m_small_read_max{1'048'576};
+
 	// Send the request to the HTTP server.
 	// Blocks until the request has completed.
 	// If `final` is set to `false`, the HTTPRequest object will start streaming
@@ -146,11 +179,20 @@ class HTTPRequest {
 
 	const std::string &getProtocol() { return m_protocol; }
 
+	// Returns the scheme://host[:port] portion of the request URL; used to
+	// key the per-endpoint transfer statistics.
+	std::string getEndpointName() const;
+
 	// Returns true if the command is a streaming/partial request.
 	// A streaming request is one that requires multiple calls to
 	// `sendPreparedRequest` to complete.
 	bool isStreamingRequest() const { return m_is_streaming; }
 
+	// Returns the priority lane the request is scheduled in.  The base
+	// class covers stat, list, and the other small control requests;
+	// data-carrying subclasses override.
+	virtual RequestLane getLane() const { return RequestLane::Metadata; }
+
 	// Record the unpause queue associated with this request.
 	//
 	// Future continuations of this request will be sent directly to this queue.
@@ -166,6 +208,12 @@ class HTTPRequest {
 	// of the server response
 	virtual void modifyResponse(std::string &) {}
 
+	// Handle the write callback from libcurl, accumulating the response
+	// body.  Protected (rather than private) so the benchmark suite can
+	// drive the accumulation path directly.
+	static size_t handleResults(const void *ptr, size_t size, size_t nmemb,
+								void *me_ptr);
+
 	typedef std::map<std::string, std::string> AttributeValueMap;
 	AttributeValueMap query_parameters;
 	AttributeValueMap headers;
@@ -189,6 +237,11 @@ class HTTPRequest {
 	std::string httpVerb{"POST"};
 	std::unique_ptr<HTTPRequest::Payload> m_callback_payload;
 
+	// When set, the upload payload is drawn from this segmented buffer
+	// (owned by the caller, which must keep it alive until the request
+	// completes) instead of the contiguous payload view.
+	const SegmentedBuffer *m_payload_segments{nullptr};
+
 	std::unique_ptr<struct curl_slist, void (*)(struct curl_slist *)>
 		m_header_list; // Headers associated with the request
 
@@ -218,10 +271,6 @@ class HTTPRequest {
 	// buffer.
 	static size_t ReadCallback(char *buffer, size_t size, size_t n, void *v);
 
-	// Handle the callback from libcurl
-	static size_t handleResults(const void *ptr, size_t size, size_t nmemb,
-								void *me_ptr);
-
 	// Transfer information callback from libcurl
 	static int XferInfoCallback(void *clientp, curl_off_t dltotal,
 								curl_off_t dlnow, curl_off_t ultotal,
@@ -250,8 +299,14 @@ class HTTPRequest {
 						 // call of the overall HTTPRequest
 	bool m_is_streaming{
 		false}; // Flag indicating this command is a streaming request.
-	bool m_timeout{false};		// Flag indicating the request has timed out.
+	// Flag indicating the request has timed out.  Set by the curl worker
+	// thread and read by the client thread submitting chunks.
+	std::atomic<bool> m_timeout{false};
 	bool m_result_ready{false}; // Flag indicating the results data is ready.
+	// Flag indicating the request ran to completion (the final response was
+	// processed or the request failed outright) as opposed to being paused
+	// partway through a streaming upload.
+	std::atomic<bool> m_completed{false};
 	bool m_result_buffer_initialized{
 		false}; // Flag indicating whether the result buffer view has been
 				// initialized.
@@ -278,13 +333,18 @@ class HTTPRequest {
 	unsigned m_retry_count{0};
 
 	// Time when the last request was sent on this object; used to determine
-	// whether the operation has timed out.
-	std::chrono::steady_clock::time_point m_last_request{
+	// whether the operation has timed out.  Written by the client thread
+	// submitting chunks and read by the curl worker's timeout scan.
+	std::atomic<std::chrono::steady_clock::time_point> m_last_request{
 		std::chrono::steady_clock::now()};
 
 	// Duration after which a partially-completed request will timeout if
 	// no progress has been made.
 	static std::chrono::steady_clock::duration m_timeout_duration;
+
+	// Total-time threshold, in milliseconds, beyond which a completed
+	// request logs its phase breakdown; zero disables the tracing.
+	static std::atomic<long> m_slow_threshold_ms;
 };
 
 class HTTPUpload : public HTTPRequest {
@@ -300,6 +360,20 @@ class HTTPUpload : public HTTPRequest {
 	virtual bool SendRequest(const std::string &payload, off_t offset,
 							 size_t size);
 
+	// Send one chunk of a streaming PUT.  The first call starts the request,
+	// which then spans every subsequent chunk until one is sent with `final`
+	// set; the payload bytes are handed to libcurl in place, with no
+	// intermediate copy.
+	//
+	// - payload: Contents of the current chunk.
+	// - payload_size: Size of the entire object if known; 0 to use chunked
+	// transfer encoding.
+	// - final: True if this is the last (or only) chunk of the upload.
+	bool SendRequest(const std::string_view payload, off_t payload_size,
+					 bool final);
+
+	RequestLane getLane() const override { return RequestLane::Bulk; }
+
   protected:
 	std::string object;
 	std::string path;
@@ -308,8 +382,8 @@ class HTTPUpload : public HTTPRequest {
 class HTTPDownload : public HTTPRequest {
   public:
 	HTTPDownload(const std::string &h, const std::string &o, XrdSysError &log,
-				 const TokenFile *token)
-		: HTTPRequest(h, log, token), object(o) {
+				 const TokenFile *token, char *buffer)
+		: HTTPRequest(h, log, token), object(o), m_buffer(buffer) {
 		hostUrl = hostUrl + "/" + object;
 	}
 
@@ -317,8 +391,53 @@ class HTTPDownload : public HTTPRequest {
 
 	virtual bool SendRequest(off_t offset, size_t size);
 
+	// A request for the entire object (size zero) is of unknown length and
+	// is treated as bulk.
+	RequestLane getLane() const override {
+		return m_request_size && m_request_size <= m_small_read_max
+				   ? RequestLane::SmallRead
+				   : RequestLane::Bulk;
+	}
+
   protected:
+	virtual bool IsBlocking() { return true; }
+	virtual std::string_view *requestResult() override {
+		return &m_buffer_view;
+	}
+
 	std::string object;
+
+	// Size of the requested range, recorded when the request is sent; used
+	// to pick between the small-read and bulk lanes.
+	size_t m_request_size{0};
+
+  private:
+	// The caller-owned destination buffer; a successful response is written
+	// straight into it instead of being accumulated (and then copied out of)
+	// the request's result string.
+	char *m_buffer{nullptr};
+	std::string_view m_buffer_view;
+};
+
+// Variant of the download command that is handed to the curl worker pool;
+// the provided notifier object's `Notify` method is invoked once the
+// transfer has completed.
+template <typename T>
+class HTTPNonblockingDownload final : public HTTPDownload {
+  public:
+	HTTPNonblockingDownload(const std::string &h, const std::string &o,
+							XrdSysError &log, const TokenFile *token,
+							char *buffer, T &notifier)
+		: HTTPDownload(h, o, log, token, buffer), m_notifier(notifier) {}
+
+	virtual ~HTTPNonblockingDownload();
+
+  protected:
+	virtual bool IsBlocking() override { return false; }
+	virtual void Notify() override { m_notifier.Notify(); }
+
+  private:
+	T &m_notifier;
 };
 
 class HTTPHead : public HTTPRequest {
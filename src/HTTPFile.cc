@@ -30,6 +30,9 @@
 #include <XrdVersion.hh>
 #include <curl/curl.h>
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <map>
@@ -37,6 +40,7 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace XrdHTTPServer;
@@ -115,6 +119,20 @@ int HTTPFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &env) {
 	m_hostname = configured_hostname;
 	m_hostUrl = configured_hostUrl;
 
+	char *asize_char;
+	if ((asize_char = env.Get("oss.asize"))) {
+		off_t result{0};
+		auto [ptr, ec] = std::from_chars(
+			asize_char, asize_char + strlen(asize_char), result);
+		if (ec == std::errc()) {
+			m_object_size = result;
+		} else {
+			m_log.Log(LogMask::Warning,
+					  "Opened file has oss.asize set to an unparseable value: ",
+					  asize_char);
+		}
+	}
+
 	if (!Oflag) {
 		struct stat buf;
 		return Fstat(&buf);
@@ -123,24 +141,19 @@ int HTTPFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &env) {
 	return 0;
 }
 
-ssize_t HTTPFile::Read(void *buffer, off_t offset, size_t size) {
-	HTTPDownload download(m_hostUrl, m_object, m_log, m_oss->getToken());
-	m_log.Log(
-		LogMask::Debug, "HTTPFile::Read",
-		"About to perform download from HTTPFile::Read(): hostname / object:",
-		m_hostname.c_str(), m_object.c_str());
+HTTPFile::~HTTPFile() { m_cache.Drain(); }
 
-	if (!download.SendRequest(offset, size)) {
-		std::stringstream ss;
-		ss << "Failed to send GetObject command: " << download.getResponseCode()
-		   << "'" << download.getResultString() << "'";
-		m_log.Log(LogMask::Warning, "HTTPFile::Read", ss.str().c_str());
-		return 0;
+ssize_t HTTPFile::Read(void *buffer, off_t offset, size_t size) {
+	if (!m_stat) {
+		// The content length is needed to clamp the read; populate it if
+		// the open did not already do so.
+		struct stat buf;
+		auto rv = Fstat(&buf);
+		if (rv != 0) {
+			return rv;
+		}
 	}
-
-	const std::string &bytes = download.getResultString();
-	memcpy(buffer, bytes.data(), bytes.size());
-	return bytes.size();
+	return m_cache.Read(*this, static_cast<char *>(buffer), offset, size);
 }
 
 int HTTPFile::Fstat(struct stat *buff) {
@@ -251,23 +264,595 @@ int HTTPFile::Fstat(struct stat *buff) {
 }
 
 ssize_t HTTPFile::Write(const void *buffer, off_t offset, size_t size) {
-	HTTPUpload upload(m_hostUrl, m_object, m_log, m_oss->getToken());
-
-	std::string payload((char *)buffer, size);
-	if (!upload.SendRequest(payload, offset, size)) {
-		m_log.Emsg("Open", "upload.SendRequest() failed");
-		return -ENOENT;
-	} else {
-		m_log.Emsg("Open", "upload.SendRequest() succeeded");
-		return 0;
+	if (m_write_offset == -1) {
+		// A previous write failed; the stream cannot be resumed.
+		return -EIO;
+	}
+	if (offset != m_write_offset) {
+		m_log.Log(LogMask::Warning, "HTTPFile::Write",
+				  "Out-of-order write detected; writes must arrive "
+				  "sequentially to be forwarded as a single PUT");
+		m_write_offset = -1;
+		return -EIO;
+	}
+	if (!m_upload) {
+		m_upload.reset(
+			new HTTPUpload(m_hostUrl, m_object, m_log, m_oss->getToken()));
+	}
+	// The caller's buffer is forwarded in place to the in-progress PUT; the
+	// request streams with the total size from the oss.asize hint when it is
+	// available and falls back to chunked transfer encoding otherwise.
+	bool final = (m_object_size >= 0) &&
+				 (offset + static_cast<off_t>(size) == m_object_size);
+	if (!m_upload->SendRequest(
+			std::string_view(static_cast<const char *>(buffer), size),
+			m_object_size >= 0 ? m_object_size : 0, final)) {
+		m_log.Log(LogMask::Warning, "HTTPFile::Write",
+				  "Streaming upload failed:",
+				  m_upload->getErrorMessage().c_str());
+		m_write_offset = -1;
+		m_upload.reset();
+		return -EIO;
 	}
+	m_write_offset += size;
+	if (final) {
+		// The sized PUT is complete; nothing remains for Close() to send.
+		m_upload.reset();
+	}
+	return size;
 }
 
 int HTTPFile::Close(long long *retsz) {
+	if (m_write_offset == -1) {
+		// A prior write failed; the upload never completed.
+		return -EIO;
+	}
+	if (m_upload) {
+		// Terminate the streaming PUT; for a chunked upload this sends the
+		// final zero-length chunk.
+		if (!m_upload->SendRequest("", m_object_size >= 0 ? m_object_size : 0,
+								   true)) {
+			m_log.Log(LogMask::Warning, "HTTPFile::Close",
+					  "Failed to complete the streaming upload:",
+					  m_upload->getErrorMessage().c_str());
+			m_upload.reset();
+			return -EIO;
+		}
+		m_upload.reset();
+	}
 	m_log.Emsg("Close", "Closed our HTTP file");
 	return 0;
 }
 
+// Copy any overlapping data from the cache buffer into the request buffer,
+// returning the remaining data necessary to fill the request.
+//
+// - `req_off`: File offset of the beginning of the request buffer.
+// - `req_size`: Size of the request buffer
+// - `req_buf`: Request buffer to copy data into
+// - `cache_off`: File offset of the beginning of the cache buffer.
+// - `cache_size`: Size of the cache buffer
+// - `cache_buf`: Cache buffer to copy data from.
+// - `used` (output): Incremented by the number of bytes copied from the cache
+// buffer
+// - Returns the (offset, size) of the remaining reads needed to satisfy the
+// request. If there is only one (or no!) remaining reads, then the
+// corresponding tuple returned is (-1, 0).
+std::tuple<off_t, size_t, off_t, size_t>
+OverlapCopy(off_t req_off, size_t req_size, char *req_buf, off_t cache_off,
+			size_t cache_size, char *cache_buf, size_t &used) {
+	if (req_off < 0) {
+		return std::make_tuple(req_off, req_size, -1, 0);
+	}
+	if (cache_off < 0) {
+		return std::make_tuple(req_off, req_size, -1, 0);
+	}
+
+	if (cache_off <= req_off) {
+		auto cache_end = cache_off + static_cast<off_t>(cache_size);
+		if (cache_end > req_off) {
+			auto cache_buf_off = static_cast<size_t>(req_off - cache_off);
+			auto cache_copy_bytes =
+				std::min(static_cast<size_t>(cache_end - req_off), req_size);
+			memcpy(req_buf, cache_buf + cache_buf_off, cache_copy_bytes);
+			used += cache_copy_bytes;
+			return std::make_tuple(req_off + cache_copy_bytes,
+								   req_size - cache_copy_bytes, -1, 0);
+		}
+	}
+	if (req_off < cache_off) {
+		auto req_end = static_cast<off_t>(req_off + req_size);
+		if (req_end > cache_off) {
+			auto req_buf_off = static_cast<size_t>(cache_off - req_off);
+			auto cache_end = static_cast<off_t>(cache_off + cache_size);
+			auto trailing_bytes = static_cast<off_t>(req_end - cache_end);
+			if (trailing_bytes > 0) {
+				memcpy(req_buf + req_buf_off, cache_buf, cache_size);
+				used += cache_size;
+				return std::make_tuple(req_off, req_buf_off, cache_end,
+									   trailing_bytes);
+			}
+			memcpy(req_buf + req_buf_off, cache_buf, req_end - cache_off);
+			used += req_end - cache_off;
+			return std::make_tuple(req_off, req_buf_off, -1, 0);
+		}
+	}
+	return std::make_tuple(req_off, req_size, -1, 0);
+}
+
+std::tuple<off_t, size_t, off_t, size_t>
+HTTPFile::HTTPCache::Entry::OverlapCopy(off_t req_off, size_t req_size,
+										char *req_buf) {
+	size_t bytes_copied = 0;
+	auto results =
+		::OverlapCopy(req_off, req_size, req_buf, m_off, m_cache_entry_size,
+					  m_data.data(), bytes_copied);
+	m_parent.m_hit_bytes += bytes_copied;
+	m_used += bytes_copied;
+	return results;
+}
+
+std::tuple<off_t, size_t, bool>
+HTTPFile::DownloadBypass(off_t offset, size_t size, char *buffer) {
+	if (size <= m_cache_entry_size) {
+		return std::make_tuple(offset, size, false);
+	}
+	HTTPDownload download(m_hostUrl, m_object, m_log, m_oss->getToken(),
+						  buffer);
+	if (!download.SendRequest(offset, size)) {
+		std::stringstream ss;
+		ss << "Failed to send GetObject command: " << download.getResponseCode()
+		   << "'" << download.getResultString() << "'";
+		m_log.Log(LogMask::Warning, "HTTPFile::Read", ss.str().c_str());
+		return std::make_tuple(0, -1, false);
+	}
+	return std::make_tuple(-1, 0, true);
+}
+
+bool HTTPFile::HTTPCache::CouldUseAligned(off_t req, off_t cache) {
+	if (req < 0 || cache < 0) {
+		return false;
+	}
+	return (req >= cache) &&
+		   (req < cache + static_cast<off_t>(HTTPFile::m_cache_entry_size));
+}
+
+bool HTTPFile::HTTPCache::CouldUse(off_t req_off, size_t req_size,
+								   off_t cache_off) {
+	if (req_off < 0 || cache_off < 0) {
+		return false;
+	}
+	auto cache_end = cache_off + static_cast<off_t>(m_cache_entry_size);
+	if (req_off >= cache_off) {
+		return req_off < cache_end;
+	} else {
+		return req_off + static_cast<off_t>(req_size) > cache_off;
+	}
+}
+
+void HTTPFile::HTTPCache::DownloadCaches(HTTPFile &file, bool download_a,
+										 bool download_b, bool locked) {
+	if (!download_a && !download_b) {
+		return;
+	}
+
+	std::unique_lock lk(m_mutex, std::defer_lock);
+	if (!locked) {
+		lk.lock();
+	}
+	if (download_a) {
+		m_a.Download(file);
+	}
+	if (download_b) {
+		m_b.Download(file);
+	}
+}
+
+ssize_t HTTPFile::HTTPCache::Read(HTTPFile &file, char *buffer, off_t offset,
+								  size_t size) {
+	if (offset >= static_cast<off_t>(file.content_length)) {
+		return 0;
+	}
+	if (offset + static_cast<off_t>(size) >
+		static_cast<off_t>(file.content_length)) {
+		size = static_cast<off_t>(file.content_length) - offset;
+	}
+	if (file.m_log.getMsgMask() & LogMask::Debug) {
+		std::stringstream ss;
+		ss << "Read request for offset=" << offset << ", size=" << size;
+		file.m_log.Log(LogMask::Debug, "cache", ss.str().c_str());
+	}
+
+	off_t req3_off, req4_off, req5_off, req6_off;
+	size_t req3_size, req4_size, req5_size, req6_size;
+	// Copy as much data out of the cache as possible; wait for the caches to
+	// finish their downloads if a cache fill is in progress and we could
+	// utilize the cache fill.
+	{
+		std::unique_lock lk{m_mutex};
+		if (m_a.m_inprogress) {
+			m_cv.wait(lk, [&] {
+				return !m_a.m_inprogress || !CouldUse(offset, size, m_a.m_off);
+			});
+		}
+		off_t req1_off, req2_off;
+		size_t req1_size, req2_size;
+		std::tie(req1_off, req1_size, req2_off, req2_size) =
+			m_a.OverlapCopy(offset, size, buffer);
+		if (m_b.m_inprogress) {
+			m_cv.wait(lk, [&] {
+				return !m_b.m_inprogress ||
+					   !(CouldUse(req1_off, req1_size, m_b.m_off) ||
+						 CouldUse(req2_off, req2_size, m_b.m_off));
+			});
+		}
+		std::tie(req3_off, req3_size, req4_off, req4_size) =
+			m_b.OverlapCopy(req1_off, req1_size, buffer + req1_off - offset);
+		std::tie(req5_off, req5_size, req6_off, req6_size) =
+			m_b.OverlapCopy(req2_off, req2_size, buffer + req2_off - offset);
+	}
+	// If any of the remaining missing bytes are bigger than a single chunk,
+	// download those bypassing the cache.
+	bool downloaded;
+	size_t bypass_size = req3_size;
+	std::tie(req3_off, req3_size, downloaded) =
+		file.DownloadBypass(req3_off, req3_size, buffer + req3_off - offset);
+	if (req3_size < 0) {
+		m_errors += 1;
+		return -1;
+	}
+	if (downloaded) {
+		m_bypass_bytes += bypass_size;
+		m_bypass_count += 1;
+	}
+	bypass_size = req4_size;
+	std::tie(req4_off, req4_size, downloaded) =
+		file.DownloadBypass(req4_off, req4_size, buffer + req4_off - offset);
+	if (req4_size < 0) {
+		m_errors += 1;
+		return -1;
+	}
+	if (downloaded) {
+		m_bypass_bytes += bypass_size;
+		m_bypass_count += 1;
+	}
+	bypass_size = req5_size;
+	std::tie(req5_off, req5_size, downloaded) =
+		file.DownloadBypass(req5_off, req5_size, buffer + req5_off - offset);
+	if (req5_size < 0) {
+		m_errors += 1;
+		return -1;
+	}
+	if (downloaded) {
+		m_bypass_bytes += bypass_size;
+		m_bypass_count += 1;
+	}
+	bypass_size = req6_size;
+	std::tie(req6_off, req6_size, downloaded) =
+		file.DownloadBypass(req6_off, req6_size, buffer + req6_off - offset);
+	if (req6_size < 0) {
+		m_errors += 1;
+		return -1;
+	}
+	if (downloaded) {
+		m_bypass_bytes += bypass_size;
+		m_bypass_count += 1;
+	}
+	if (req3_size == 0 && req4_size == 0 && req5_size == 0 && req6_size == 0) {
+		m_full_hit_count += 1;
+		// We've used more bytes in the cache, potentially all of the bytes.
+		// In that case, we could drop one of the cache entries and prefetch
+		// more of the object.
+		bool download_a = false, download_b = false;
+		{
+			std::unique_lock lk{m_mutex};
+			auto next_offset = std::max(m_a.m_off, m_b.m_off) +
+							   static_cast<off_t>(m_cache_entry_size);
+			if (next_offset < static_cast<off_t>(file.content_length)) {
+				if (!m_a.m_inprogress && m_a.m_used >= m_cache_entry_size) {
+					m_a.m_inprogress = true;
+					m_a.m_off = next_offset;
+					download_a = true;
+					next_offset += m_cache_entry_size;
+				}
+				if (!m_b.m_inprogress && m_b.m_used >= m_cache_entry_size) {
+					m_b.m_inprogress = true;
+					m_b.m_off = next_offset;
+					download_b = true;
+				}
+			}
+		}
+		if (download_a) {
+			m_prefetch_count++;
+			m_prefetch_bytes += m_cache_entry_size;
+		}
+		if (download_b) {
+			m_prefetch_count++;
+			m_prefetch_bytes += m_cache_entry_size;
+		}
+		DownloadCaches(file, download_a, download_b, false);
+		return size;
+	}
+	// At this point, the only remaining data requests must be less than the
+	// size of the cache chunk, implying it's a partial request at the beginning
+	// or end of the range -- hence only two can exist.
+	off_t req1_off = -1, req2_off = -1;
+	off_t *req_off = &req1_off;
+	size_t req1_size = 0, req2_size = 0;
+	size_t *req_size = &req1_size;
+	if (req3_off != -1) {
+		*req_off = req3_off;
+		*req_size = req3_size;
+		req_off = &req2_off;
+		req_size = &req2_size;
+	}
+	if (req4_off != -1) {
+		*req_off = req4_off;
+		*req_size = req4_size;
+		req_off = &req2_off;
+		req_size = &req2_size;
+	}
+	if (req5_off != -1) {
+		*req_off = req5_off;
+		*req_size = req5_size;
+		req_off = &req2_off;
+		req_size = &req2_size;
+	}
+	if (req6_off != -1) {
+		*req_off = req6_off;
+		*req_size = req6_size;
+	}
+	if (req1_off != -1 && req2_off == -1) {
+		auto chunk_off = static_cast<off_t>(req1_off / m_cache_entry_size *
+												m_cache_entry_size +
+											m_cache_entry_size);
+		auto req_end = static_cast<off_t>(req1_off + req1_size);
+
+		if (req_end > chunk_off) {
+			req2_off = chunk_off;
+			req2_size = req_end - chunk_off;
+			req1_size = chunk_off - req1_off;
+		}
+	}
+	size_t miss_bytes = req1_size + req2_size;
+	if (miss_bytes == size) {
+		m_miss_count += 1;
+	} else {
+		m_partial_hit_count += 1;
+	}
+	m_miss_bytes += miss_bytes;
+	while (req1_off != -1) {
+		std::unique_lock lk(m_mutex);
+		m_cv.wait(lk, [&] {
+			bool req1waitOnA =
+				m_a.m_inprogress && CouldUseAligned(req1_off, m_a.m_off);
+			bool req2waitOnA =
+				m_a.m_inprogress && CouldUseAligned(req2_off, m_a.m_off);
+			bool req1waitOnB =
+				m_b.m_inprogress && CouldUseAligned(req1_off, m_b.m_off);
+			bool req2waitOnB =
+				m_b.m_inprogress && CouldUseAligned(req2_off, m_b.m_off);
+			// If there's an idle cache entry, use it -- unless the other cache
+			// entry is working on this request.
+			if (!m_a.m_inprogress && !req1waitOnB && !req2waitOnB) {
+				return true;
+			}
+			if (!m_b.m_inprogress && !req1waitOnA && !req2waitOnA) {
+				return true;
+			}
+			// If an idle cache entry can immediately satisfy the request, we
+			// use it.
+			if (!m_a.m_inprogress && (CouldUseAligned(req1_off, m_a.m_off) ||
+									  CouldUseAligned(req2_off, m_a.m_off))) {
+				return true;
+			}
+			if (!m_b.m_inprogress && (CouldUseAligned(req1_off, m_b.m_off) ||
+									  CouldUseAligned(req2_off, m_b.m_off))) {
+				return true;
+			}
+			// If either request is in progress, we continue to wait.
+			if (req1waitOnA || req1waitOnB || req2waitOnA || req2waitOnB) {
+				return false;
+			}
+			// If either cache is idle, we will use it.
+			return !m_a.m_inprogress || !m_b.m_inprogress;
+		});
+		// Test to see if any of the buffers could immediately fulfill the
+		// requests.
+		auto consumed_req = false;
+		if (!m_a.m_inprogress) {
+			if (CouldUseAligned(req2_off, m_a.m_off)) {
+				if (m_a.m_failed) {
+					m_a.m_failed = false;
+					m_a.m_off = -1;
+					m_errors += 1;
+					return -1;
+				}
+				m_a.OverlapCopy(req2_off, req2_size,
+								buffer + req2_off - offset);
+				req2_off = -1;
+				req2_size = 0;
+				consumed_req = true;
+			}
+			if (CouldUseAligned(req1_off, m_a.m_off)) {
+				if (m_a.m_failed) {
+					m_a.m_failed = false;
+					m_a.m_off = -1;
+					m_errors += 1;
+					return -1;
+				}
+				m_a.OverlapCopy(req1_off, req1_size,
+								buffer + req1_off - offset);
+				req1_off = req2_off;
+				req1_size = req2_size;
+				req2_off = -1;
+				req2_size = 0;
+				consumed_req = true;
+			}
+		}
+		if (!m_b.m_inprogress) {
+			if (CouldUseAligned(req2_off, m_b.m_off)) {
+				if (m_b.m_failed) {
+					m_b.m_failed = false;
+					m_b.m_off = -1;
+					m_errors += 1;
+					return -1;
+				}
+				m_b.OverlapCopy(req2_off, req2_size,
+								buffer + req2_off - offset);
+				req2_off = -1;
+				req2_size = 0;
+				consumed_req = true;
+			}
+			if (CouldUseAligned(req1_off, m_b.m_off)) {
+				if (m_b.m_failed) {
+					m_b.m_failed = false;
+					m_b.m_off = -1;
+					m_errors += 1;
+					return -1;
+				}
+				m_b.OverlapCopy(req1_off, req1_size,
+								buffer + req1_off - offset);
+				req1_off = req2_off;
+				req1_size = req2_size;
+				req2_off = -1;
+				req2_size = 0;
+				consumed_req = true;
+			}
+		}
+		if (consumed_req) {
+			continue;
+		}
+
+		// No caches serve our requests - we must kick off a new download
+		bool download_a = false, download_b = false, prefetch_b = false;
+		if (!m_a.m_inprogress && m_b.m_inprogress) {
+			m_a.m_off = req1_off / m_cache_entry_size * m_cache_entry_size;
+			m_a.m_inprogress = true;
+			download_a = true;
+		} else if (m_a.m_inprogress && !m_b.m_inprogress) {
+			m_b.m_off = req1_off / m_cache_entry_size * m_cache_entry_size;
+			m_b.m_inprogress = true;
+			download_b = true;
+		} else if (!m_a.m_inprogress && !m_b.m_inprogress) {
+			if (req2_off != -1) {
+				m_a.m_off = req1_off / m_cache_entry_size * m_cache_entry_size;
+				m_a.m_inprogress = true;
+				download_a = true;
+				m_b.m_off = req2_off / m_cache_entry_size * m_cache_entry_size;
+				m_b.m_inprogress = true;
+				download_b = true;
+			} else {
+				if (m_a.m_used >= m_cache_entry_size) {
+					// Cache A is fully read -- let's empty it
+					m_a.m_off = m_b.m_off;
+					m_b.m_off = -1;
+					m_a.m_used = m_b.m_used;
+					m_b.m_used = 0;
+					std::swap(m_a.m_data, m_b.m_data);
+				}
+				if (m_a.m_used >= m_cache_entry_size) {
+					// Both caches were fully read -- empty the second one.
+					m_a.m_off = -1;
+					m_a.m_used = 0;
+				}
+				if (m_a.m_off == -1 && m_b.m_off == -1) {
+					// Prefetch both caches at once
+					m_a.m_off = req1_off /
+								static_cast<off_t>(m_cache_entry_size) *
+								static_cast<off_t>(m_cache_entry_size);
+					auto prefetch_offset =
+						m_a.m_off + static_cast<off_t>(m_cache_entry_size);
+					;
+					download_a = true;
+					m_a.m_inprogress = true;
+					if (prefetch_offset < static_cast<off_t>(file.content_length)) {
+						m_b.m_off = prefetch_offset;
+						prefetch_b = true;
+						m_b.m_inprogress = true;
+					}
+				} else {
+					// Select one cache entry to fetch data.
+					auto needed_off = req1_off /
+									  static_cast<off_t>(m_cache_entry_size) *
+									  static_cast<off_t>(m_cache_entry_size);
+					if (needed_off > m_a.m_off) {
+						m_b.m_off = needed_off;
+						download_b = true;
+						m_b.m_inprogress = true;
+						auto bytes_unused =
+							static_cast<ssize_t>(m_cache_entry_size) -
+							static_cast<ssize_t>(m_b.m_used);
+						m_unused_bytes += bytes_unused < 0 ? 0 : bytes_unused;
+					} else {
+						m_a.m_off = needed_off;
+						download_a = true;
+						m_a.m_inprogress = true;
+						auto bytes_unused =
+							static_cast<ssize_t>(m_cache_entry_size) -
+							static_cast<ssize_t>(m_a.m_used);
+						m_unused_bytes += bytes_unused < 0 ? 0 : bytes_unused;
+					}
+				}
+			}
+		} // else both caches are in-progress and neither satisfied our needs
+		if (download_a) {
+			m_fetch_count += 1;
+			m_fetch_bytes += m_cache_entry_size;
+		}
+		if (download_b) {
+			m_fetch_count += 1;
+			m_fetch_bytes += m_cache_entry_size;
+		}
+		if (prefetch_b) {
+			m_prefetch_count += 1;
+			m_prefetch_bytes += m_cache_entry_size;
+		}
+		DownloadCaches(file, download_a, download_b || prefetch_b, true);
+	}
+	return size;
+}
+
+void HTTPFile::HTTPCache::Entry::Notify() {
+	std::unique_lock lk(m_parent.m_mutex);
+	m_inprogress = false;
+	m_failed = !m_request->getErrorCode().empty();
+	m_request = nullptr;
+
+	m_parent.m_cv.notify_all();
+}
+
+void HTTPFile::HTTPCache::Entry::Download(HTTPFile &file) {
+	m_used = 0;
+	m_data.resize(m_cache_entry_size);
+	m_request.reset(new HTTPNonblockingDownload<Entry>(
+		file.m_hostUrl, file.m_object, file.m_log, file.m_oss->getToken(),
+		m_data.data(), *this));
+	size_t request_size = m_cache_entry_size;
+	if (m_off + static_cast<off_t>(request_size) >
+		static_cast<off_t>(file.content_length)) {
+		request_size = file.content_length - m_off;
+	}
+	if (!m_request->SendRequest(m_off, request_size)) {
+		std::stringstream ss;
+		ss << "Failed to send GetObject command: "
+		   << m_request->getResponseCode() << "'"
+		   << m_request->getResultString() << "'";
+		file.m_log.Log(LogMask::Warning, "HTTPFile::Read", ss.str().c_str());
+		m_failed = true;
+		m_request.reset();
+	}
+}
+
+void HTTPFile::HTTPCache::Drain() {
+	std::unique_lock lk(m_mutex);
+	m_cv.wait(lk, [&] { return !m_a.m_inprogress && !m_b.m_inprogress; });
+}
+
+template <typename T>
+HTTPNonblockingDownload<T>::~HTTPNonblockingDownload() {}
+template class HTTPNonblockingDownload<HTTPFile::HTTPCache::Entry>;
+
 extern "C" {
 
 /*
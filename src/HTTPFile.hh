@@ -25,16 +25,25 @@
 #include "XrdSec/XrdSecEntityAttr.hh"
 #include "XrdVersion.hh"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
 
 int parse_path(const std::string &hostname, const char *path,
 			   std::string &object);
 
+template <typename T> class HTTPNonblockingDownload;
+class HTTPUpload;
+
 class HTTPFile : public XrdOssDF {
   public:
 	HTTPFile(XrdSysError &log, HTTPFileSystem *oss);
 
-	virtual ~HTTPFile() {}
+	virtual ~HTTPFile();
 
 	virtual int Open(const char *path, int Oflag, mode_t Mode,
 					 XrdOucEnv &env) override;
@@ -95,6 +104,18 @@ class HTTPFile : public XrdOssDF {
 	time_t getLastModified() { return last_modified; }
 
   private:
+	// Download data synchronously, bypassing the cache.
+	// The download is only performed if the request size is larger than a
+	// cache entry.
+	//
+	// - `offset`: File offset of the request.
+	// - `size`: Size of the request.
+	// - `buffer`: Buffer to place resulting data into.
+	// - Returns the (offset, size) of any remaining read and `true` if a
+	// download occured.
+	std::tuple<off_t, size_t, bool> DownloadBypass(off_t offset, size_t size,
+												   char *buffer);
+
 	bool m_stat{false};
 
 	XrdSysError &m_log;
@@ -106,4 +127,119 @@ class HTTPFile : public XrdOssDF {
 
 	size_t content_length;
 	time_t last_modified;
+
+	// The in-progress streaming PUT backing writes to this handle; one
+	// request spans every write to the open file.
+	std::unique_ptr<HTTPUpload> m_upload;
+
+	// Offset of the next expected write; writes must arrive in order as
+	// they are forwarded to the server as a single PUT.  Set to -1 after a
+	// failed write.
+	off_t m_write_offset{0};
+
+	// Expected size of the object being written, taken from the oss.asize
+	// hint at open; -1 when unknown (the PUT then uses chunked transfer
+	// encoding).
+	off_t m_object_size{-1};
+
+	static constexpr size_t m_cache_entry_size =
+		(2 * 1024 * 1024); // Size of the buffer associated with the cache
+
+	// The double-buffering component for the file handle.  Reads are rounded
+	// up to a particular size and kept in the file handle; before requesting
+	// new data, the cache is searched to see if the read can be serviced from
+	// memory.  When possible, a forward prefetch is done
+	struct HTTPCache {
+		struct Entry {
+			bool m_failed{false}; // Indication as to whether last download
+								  // attempt failed for cache entry.
+			bool m_inprogress{
+				false}; // Indication as to whether a download is in-progress.
+			off_t m_off{-1}; // File offset of the beginning of the cache entry.
+							 // -1 signifies unused entry
+			size_t m_used{
+				0}; // The number of bytes read out of the current cache entry.
+			std::vector<char> m_data; // Contents of cache entry
+			HTTPCache &m_parent;	  // Reference to owning object
+			std::unique_ptr<HTTPNonblockingDownload<Entry>>
+				m_request; // In-progress request to fill entry.
+
+			Entry(HTTPCache &cache) : m_parent(cache) {}
+			void Download(
+				HTTPFile &); // Trigger download request for this cache entry.
+			void Notify();	 // Notify containing cache that the entry's
+							 // in-progress operation has completed.
+
+			// Copy any overlapping data from the cache buffer into the request
+			// buffer, returning the remaining data necessary to fill the
+			// request.
+			//
+			// - `req_off`: File offset of the beginning of the request buffer.
+			// - `req_size`: Size of the request buffer
+			// - `req_buf`: Request buffer to copy data into
+			// - Returns the (offset, size) of the remaining reads needed to
+			// satisfy the request. If there is only one (or no!) remaining
+			// reads, then the corresponding tuple returned is (-1, 0).
+			std::tuple<off_t, size_t, off_t, size_t>
+			OverlapCopy(off_t req_off, size_t req_size, char *req_buf);
+		};
+		friend class HTTPNonblockingDownload<HTTPFile::HTTPCache::Entry>;
+
+		std::atomic<off_t> m_hit_bytes{0}; // Bytes served from the cache.
+		std::atomic<off_t> m_miss_bytes{
+			0}; // Bytes that resulted in a cache miss.
+		std::atomic<off_t> m_full_hit_count{
+			0}; // Requests completely served from the cache.
+		std::atomic<off_t> m_partial_hit_count{
+			0}; // Requests partially served from the cache.
+		std::atomic<off_t> m_miss_count{
+			0}; // Requests that had no data served from the cache.
+		std::atomic<off_t> m_bypass_bytes{
+			0}; // Bytes for requests that were large enough they bypassed the
+				// cache and fetched directly from the origin.
+		std::atomic<off_t> m_bypass_count{
+			0}; // Requests that were large enough they (at least partially)
+				// bypassed the cache and fetched directly from the origin.
+		std::atomic<off_t> m_fetch_bytes{
+			0}; // Bytes that were fetched from the origin to serve a miss.
+		std::atomic<off_t> m_fetch_count{
+			0}; // Requests sent to the origin to serve a cache miss.
+		std::atomic<off_t> m_unused_bytes{
+			0}; // Bytes that were unused at cache eviction.
+		std::atomic<off_t> m_prefetch_bytes{0}; // Bytes prefetched
+		std::atomic<off_t> m_prefetch_count{0}; // Number of prefetch requests
+		std::atomic<off_t> m_errors{0}; // Count of errors encountered by cache.
+
+		Entry m_a{*this};	// Cache entry A.  Protected by m_mutex.
+		Entry m_b{*this};	// Cache entry B.  Protected by m_mutex.
+		std::mutex m_mutex; // Mutex protecting the data in the cache object
+		std::condition_variable m_cv; // Condition variable for notifying that
+									  // new downloaded data is available.
+
+		// Returns `true` if the request offset would be inside the cache
+		// entry. The request offset is assumed to be aligned to be inside a
+		// single cache entry (that is, smaller than a cache entry and not
+		// spanning two entries).
+		bool CouldUseAligned(off_t req, off_t cache);
+
+		// Returns true if the specified request, [req_off, req_off +
+		// req_size), has any bytes inside the cache entry starting at
+		// `cache_off`.
+		bool CouldUse(off_t req_off, size_t req_size, off_t cache_off);
+
+		// Trigger the non-blocking download into the cache entries.
+		// The condition variable will be notified when one of the caches
+		// finishes.
+		void DownloadCaches(HTTPFile &file, bool download_a, bool download_b,
+							bool locked);
+
+		// Trigger a blocking read from a given file
+		ssize_t Read(HTTPFile &file, char *buffer, off_t offset, size_t size);
+
+		// Block until any in-flight downloads into the cache entries have
+		// completed; must be invoked before the cache object is destroyed as
+		// the downloads reference the entry buffers.
+		void Drain();
+	};
+	HTTPCache m_cache;
 };
@@ -17,6 +17,8 @@
  ***************************************************************/
 
 #include "HTTPFileSystem.hh"
+#include "CurlWorker.hh"
+#include "HTTPCommands.hh"
 #include "HTTPDirectory.hh"
 #include "HTTPFile.hh"
 #include "logging.hh"
@@ -26,6 +28,8 @@
 #include <XrdSec/XrdSecEntity.hh>
 #include <XrdVersion.hh>
 
+#include <charconv>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
@@ -102,6 +106,54 @@ bool HTTPFileSystem::Config(XrdSysLogger *lp, const char *configfn) {
 			continue;
 		}
 
+		if (!strcmp(attribute, "httpserver.worker_threads")) {
+			unsigned threads{0};
+			auto [ptr, ec] =
+				std::from_chars(value, value + strlen(value), threads);
+			if (ec != std::errc() || ptr != value + strlen(value) ||
+				threads == 0) {
+				m_log.Emsg(
+					"Config",
+					"httpserver.worker_threads must be a positive integer:",
+					value);
+				return false;
+			}
+			CurlWorker::SetPollThreads(threads);
+			continue;
+		}
+
+		if (!strcmp(attribute, "httpserver.max_concurrent_streams")) {
+			long streams{0};
+			auto [ptr, ec] =
+				std::from_chars(value, value + strlen(value), streams);
+			if (ec != std::errc() || ptr != value + strlen(value) ||
+				streams <= 0) {
+				m_log.Emsg("Config",
+						   "httpserver.max_concurrent_streams must be a "
+						   "positive integer:",
+						   value);
+				return false;
+			}
+			CurlWorker::SetMaxConcurrentStreams(streams);
+			continue;
+		}
+
+		if (!strcmp(attribute, "httpserver.slow_request_threshold")) {
+			size_t threshold{0};
+			auto [ptr, ec] =
+				std::from_chars(value, value + strlen(value), threshold);
+			if (ec != std::errc() || ptr != value + strlen(value)) {
+				m_log.Emsg("Config",
+						   "httpserver.slow_request_threshold must be a time "
+						   "in milliseconds:",
+						   value);
+				return false;
+			}
+			HTTPRequest::SetSlowRequestThreshold(
+				std::chrono::milliseconds(threshold));
+			continue;
+		}
+
 		if (!handle_required_config(attribute, "httpserver.host_name", value,
 									http_host_name) ||
 			!handle_required_config(attribute, "httpserver.host_url", value,
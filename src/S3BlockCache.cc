@@ -0,0 +1,290 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "S3BlockCache.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Default memory budget for the shared block cache; overridden by the
+// `s3.cache_size` configuration directive.
+std::atomic<size_t> S3BlockCache::m_max_size{512 * 1024 * 1024};
+
+// Budget and location for the disk spill tier; disabled unless configured
+// via the `s3.disk_cache_dir` and `s3.disk_cache_size` directives.
+std::atomic<size_t> S3BlockCache::m_disk_max_size{0};
+std::string S3BlockCache::m_disk_dir;
+
+void S3BlockCache::SetDiskCache(const std::string &directory, size_t bytes) {
+	m_disk_dir = directory;
+	m_disk_max_size = directory.empty() ? 0 : bytes;
+}
+
+S3BlockCache &S3BlockCache::Instance() {
+	static S3BlockCache instance;
+	return instance;
+}
+
+std::shared_ptr<const std::vector<char>>
+S3BlockCache::Get(const std::string &key, off_t offset) {
+	if (!m_max_size) {
+		return nullptr;
+	}
+
+	std::unique_lock lk(m_mutex);
+	auto mapKey = MapKey(key, offset);
+	auto iter = m_blocks.find(mapKey);
+	if (iter != m_blocks.end()) {
+		// Move the block to the front of the LRU list.
+		m_lru.splice(m_lru.begin(), m_lru, iter->second);
+		m_shared_hit_count++;
+		return iter->second->m_data;
+	}
+	// Miss in memory; promote the block from the disk tier if it was
+	// previously spilled there.
+	auto diskIter = m_disk_max_size ? m_disk_blocks.find(mapKey)
+									: m_disk_blocks.end();
+	if (diskIter == m_disk_blocks.end()) {
+		m_shared_miss_count++;
+		return nullptr;
+	}
+	// Pin the slot so it is not recycled while we read it with the lock
+	// dropped; other lookups proceed during the disk I/O.
+	diskIter->second->m_pins++;
+	auto slot = diskIter->second->m_slot;
+	auto size = diskIter->second->m_size;
+	lk.unlock();
+	auto data = std::make_shared<std::vector<char>>(size);
+	auto rv = pread(m_disk_fd, data->data(), size, slot * m_disk_slot_size);
+	lk.lock();
+	diskIter = m_disk_blocks.find(mapKey);
+	if (diskIter == m_disk_blocks.end() || diskIter->second->m_slot != slot) {
+		// The object was invalidated while we read, so the bytes are
+		// suspect; release our pin via the zombie ledger.
+		ReleaseZombie(slot);
+		m_shared_miss_count++;
+		return nullptr;
+	}
+	auto &entry = *diskIter->second;
+	entry.m_pins--;
+	if (rv != static_cast<ssize_t>(size)) {
+		// Unreadable slot; drop the index entry and recycle the slot once
+		// the remaining readers have released it.
+		if (entry.m_pins) {
+			m_zombie_slots[slot] = entry.m_pins;
+		} else {
+			m_free_slots.push_back(slot);
+		}
+		m_disk_lru.erase(diskIter->second);
+		m_disk_blocks.erase(diskIter);
+		m_shared_miss_count++;
+		return nullptr;
+	}
+	m_disk_lru.splice(m_disk_lru.begin(), m_disk_lru, diskIter->second);
+	auto memIter = m_blocks.find(mapKey);
+	if (memIter != m_blocks.end()) {
+		// A concurrent lookup promoted the block while we read it; keep
+		// the copy already in memory.
+		m_lru.splice(m_lru.begin(), m_lru, memIter->second);
+		m_disk_hit_count++;
+		return memIter->second->m_data;
+	}
+	m_lru.push_front(Block{key, offset, data});
+	m_blocks[mapKey] = m_lru.begin();
+	m_size += data->size();
+	std::vector<PendingSpill> pending;
+	EvictExcess(pending);
+	m_disk_hit_count++;
+	lk.unlock();
+	CompleteSpills(pending);
+	return data;
+}
+
+void S3BlockCache::Put(const std::string &key, off_t offset,
+					   std::shared_ptr<const std::vector<char>> data) {
+	if (!m_max_size || !data) {
+		return;
+	}
+
+	std::unique_lock lk(m_mutex);
+	auto mapKey = MapKey(key, offset);
+	auto iter = m_blocks.find(mapKey);
+	if (iter != m_blocks.end()) {
+		// Another file handle raced us to download this block; keep the
+		// existing copy and simply refresh its LRU position.
+		m_lru.splice(m_lru.begin(), m_lru, iter->second);
+		return;
+	}
+	m_lru.push_front(Block{key, offset, data});
+	m_blocks[mapKey] = m_lru.begin();
+	m_size += data->size();
+	std::vector<PendingSpill> pending;
+	EvictExcess(pending);
+	lk.unlock();
+	CompleteSpills(pending);
+}
+
+void S3BlockCache::Invalidate(const std::string &key) {
+	if (!m_max_size) {
+		return;
+	}
+
+	std::lock_guard lk(m_mutex);
+	// Spills prepared before this point may carry the object's old bytes;
+	// advancing the epoch makes CompleteSpills discard them.
+	m_epoch++;
+	for (auto iter = m_lru.begin(); iter != m_lru.end();) {
+		if (iter->m_key == key) {
+			m_size -= iter->m_data->size();
+			m_blocks.erase(MapKey(iter->m_key, iter->m_offset));
+			iter = m_lru.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	for (auto iter = m_disk_lru.begin(); iter != m_disk_lru.end();) {
+		if (iter->m_key == key) {
+			if (iter->m_pins) {
+				// In-flight promotions are still reading the slot; the
+				// last of them returns it to the free list.
+				m_zombie_slots[iter->m_slot] = iter->m_pins;
+			} else {
+				m_free_slots.push_back(iter->m_slot);
+			}
+			m_disk_blocks.erase(MapKey(iter->m_key, iter->m_offset));
+			iter = m_disk_lru.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+void S3BlockCache::EvictExcess(std::vector<PendingSpill> &pending) {
+	while (m_size > m_max_size && !m_lru.empty()) {
+		auto &victim = m_lru.back();
+		PrepareSpill(victim, pending);
+		m_size -= victim.m_data->size();
+		m_blocks.erase(MapKey(victim.m_key, victim.m_offset));
+		m_lru.pop_back();
+		m_eviction_count++;
+	}
+}
+
+bool S3BlockCache::EnsureDiskOpen() {
+	if (m_disk_fd >= 0) {
+		return true;
+	}
+	if (m_disk_fd == -2 || m_disk_dir.empty() || !m_disk_max_size) {
+		return false;
+	}
+	// The slot file is truncated on first use: the index lives only in
+	// memory, so blocks from a previous run could never be found again.
+	auto path = m_disk_dir + "/blocks.cache";
+	m_disk_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (m_disk_fd == -1) {
+		m_disk_fd = -2;
+		return false;
+	}
+	return true;
+}
+
+void S3BlockCache::PrepareSpill(const Block &block,
+								std::vector<PendingSpill> &pending) {
+	if (!m_disk_max_size || block.m_data->size() > m_disk_slot_size ||
+		!EnsureDiskOpen()) {
+		return;
+	}
+	auto mapKey = MapKey(block.m_key, block.m_offset);
+	auto iter = m_disk_blocks.find(mapKey);
+	if (iter != m_disk_blocks.end()) {
+		// Still resident from an earlier spill; the contents cannot have
+		// changed, so just refresh the LRU position.
+		m_disk_lru.splice(m_disk_lru.begin(), m_disk_lru, iter->second);
+		return;
+	}
+	auto slot = AssignSlot();
+	if (slot == m_invalid_slot) {
+		return;
+	}
+	// The slot is reserved but not yet indexed; the write happens in
+	// CompleteSpills, once the caller has dropped the lock.
+	pending.push_back(PendingSpill{block.m_key, block.m_offset, block.m_data,
+								   slot, m_epoch});
+}
+
+void S3BlockCache::CompleteSpills(std::vector<PendingSpill> &pending) {
+	if (pending.empty()) {
+		return;
+	}
+	for (auto &spill : pending) {
+		auto rv = pwrite(m_disk_fd, spill.m_data->data(), spill.m_data->size(),
+						 spill.m_slot * m_disk_slot_size);
+		spill.m_ok = rv == static_cast<ssize_t>(spill.m_data->size());
+	}
+	std::lock_guard lk(m_mutex);
+	for (auto &spill : pending) {
+		auto mapKey = MapKey(spill.m_key, spill.m_offset);
+		// A torn write leaves the slot contents suspect; an invalidation
+		// since the spill was prepared may make them stale; a concurrent
+		// spill may have indexed the block already.  In every case the
+		// reserved slot just goes back on the free list.
+		if (!spill.m_ok || spill.m_epoch != m_epoch ||
+			m_disk_blocks.find(mapKey) != m_disk_blocks.end()) {
+			m_free_slots.push_back(spill.m_slot);
+			continue;
+		}
+		m_disk_lru.push_front(DiskBlock{spill.m_key, spill.m_offset,
+										spill.m_slot, spill.m_data->size()});
+		m_disk_blocks[mapKey] = m_disk_lru.begin();
+		m_disk_spill_count++;
+	}
+}
+
+size_t S3BlockCache::AssignSlot() {
+	if (!m_free_slots.empty()) {
+		auto slot = m_free_slots.back();
+		m_free_slots.pop_back();
+		return slot;
+	}
+	if ((m_next_slot + 1) * m_disk_slot_size <= m_disk_max_size) {
+		return m_next_slot++;
+	}
+	// The file is at budget; evict the least-recently-used disk block,
+	// skipping slots pinned by in-flight promotions.
+	for (auto iter = m_disk_lru.rbegin(); iter != m_disk_lru.rend(); ++iter) {
+		if (iter->m_pins) {
+			continue;
+		}
+		auto slot = iter->m_slot;
+		m_disk_blocks.erase(MapKey(iter->m_key, iter->m_offset));
+		m_disk_lru.erase(std::next(iter).base());
+		return slot;
+	}
+	return m_invalid_slot;
+}
+
+void S3BlockCache::ReleaseZombie(size_t slot) {
+	auto iter = m_zombie_slots.find(slot);
+	if (iter == m_zombie_slots.end()) {
+		return;
+	}
+	if (--iter->second == 0) {
+		m_zombie_slots.erase(iter);
+		m_free_slots.push_back(slot);
+	}
+}
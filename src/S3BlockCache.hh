@@ -0,0 +1,201 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A process-wide, memory-budgeted cache of downloaded object blocks.
+//
+// Each open S3File keeps a small number of in-flight cache entries of its
+// own; completed blocks are published here so that other file handles
+// (or a later re-open of the same object) reading the same ranges can be
+// served from memory instead of re-fetching from the S3 endpoint.
+//
+// Blocks are keyed by (endpoint/bucket/object, block offset) and evicted
+// in least-recently-used order once the configured memory budget is
+// exceeded.  When a disk spill tier is configured, evicted blocks are
+// written to a local slot file and promoted back into memory on a later
+// read instead of being re-fetched from the endpoint.  The disk index is
+// keyed like the memory tier (not by the object's ETag): the slot file is
+// truncated at startup and its index lives only in memory, so entries
+// never outlive the process, and within the process Invalidate() drops
+// both tiers whenever the object is known to have changed.
+// Note the cache is not revalidated against the object's ETag; local
+// mutations (writes, unlink, rename) drop the object's blocks via
+// Invalidate(), but objects are assumed not to be modified by other
+// actors for the duration they're cached.
+class S3BlockCache {
+  public:
+	// Returns the singleton cache instance shared by all S3File objects.
+	static S3BlockCache &Instance();
+
+	// Set the memory budget, in bytes, for cached blocks.  A budget of 0
+	// disables the shared cache entirely.  Invoked at config time, before
+	// any file I/O starts.
+	static void SetCacheSize(size_t bytes) { m_max_size = bytes; }
+
+	static size_t GetCacheSize() { return m_max_size; }
+
+	// Configure the disk spill tier.  Blocks evicted from the in-memory
+	// tier are written into fixed-size slots of a file under `directory`
+	// (up to `bytes` in total) and promoted back into memory when re-read,
+	// converting re-reads of cold data into local disk I/O instead of S3
+	// round trips.  An empty directory disables the tier.  Invoked at
+	// config time, before any file I/O starts.
+	static void SetDiskCache(const std::string &directory, size_t bytes);
+
+	// Look up a block in the cache.
+	//
+	// - `key`: Cache key for the object (endpoint, bucket and object name).
+	// - `offset`: File offset of the beginning of the block.
+	// - Returns the block contents, or nullptr on a cache miss.
+	std::shared_ptr<const std::vector<char>> Get(const std::string &key,
+												 off_t offset);
+
+	// Publish a downloaded block into the cache, potentially evicting the
+	// least-recently-used blocks to stay within the memory budget.
+	void Put(const std::string &key, off_t offset,
+			 std::shared_ptr<const std::vector<char>> data);
+
+	// Drop every cached block -- in memory and in the disk tier -- for the
+	// given object key.  Invoked wherever this process knows the object
+	// changed (a completed write, an unlink, a rename), alongside the stat
+	// and listing cache invalidations.
+	void Invalidate(const std::string &key);
+
+	// Bytes served out of the shared cache.
+	std::atomic<off_t> m_shared_hit_count{0};
+	// Lookups that found no usable block.
+	std::atomic<off_t> m_shared_miss_count{0};
+	// Count of blocks evicted to stay within the memory budget.
+	std::atomic<off_t> m_eviction_count{0};
+	// Lookups served by promoting a block from the disk tier.
+	std::atomic<off_t> m_disk_hit_count{0};
+	// Count of evicted blocks written into the disk tier.
+	std::atomic<off_t> m_disk_spill_count{0};
+
+  private:
+	S3BlockCache() = default;
+	S3BlockCache(const S3BlockCache &) = delete;
+
+	struct Block {
+		std::string m_key;
+		off_t m_offset;
+		std::shared_ptr<const std::vector<char>> m_data;
+	};
+
+	// Combined (object, offset) key for the block map.
+	static std::string MapKey(const std::string &key, off_t offset) {
+		return key + "@" + std::to_string(offset);
+	}
+
+	// One block resident in the disk tier.
+	struct DiskBlock {
+		std::string m_key;
+		off_t m_offset;
+		size_t m_slot; // Index of the block's fixed-size slot in the file.
+		size_t m_size; // Number of valid bytes in the slot.
+		// Number of in-flight promotions reading the slot without the
+		// lock held; pinned slots are never recycled.
+		int m_pins{0};
+	};
+
+	// One evicted block whose slot is reserved but whose disk write has
+	// not happened yet; the write runs in CompleteSpills(), outside
+	// m_mutex, so lookups do not stall behind the disk I/O.
+	struct PendingSpill {
+		std::string m_key;
+		off_t m_offset;
+		std::shared_ptr<const std::vector<char>> m_data;
+		size_t m_slot;	  // Slot reserved for the block.
+		uint64_t m_epoch; // Invalidation epoch when the spill was prepared.
+		bool m_ok{false}; // Set once the slot write succeeded.
+	};
+
+	// Evict LRU blocks until the cache is within budget, reserving a
+	// disk-tier slot for each victim; the caller performs the writes via
+	// CompleteSpills() after dropping m_mutex.  Caller must hold m_mutex.
+	void EvictExcess(std::vector<PendingSpill> &pending);
+
+	// Open the spill file if configured, returning false when the disk
+	// tier is unavailable.  Caller must hold m_mutex.
+	bool EnsureDiskOpen();
+
+	// Reserve a disk-tier slot for an evicted block, queueing the write
+	// onto `pending`; does nothing when the tier is unavailable or the
+	// block is already resident there.  Caller must hold m_mutex.
+	void PrepareSpill(const Block &block, std::vector<PendingSpill> &pending);
+
+	// Perform the queued slot writes and index the blocks that landed
+	// intact (dropping any the object was invalidated out from under).
+	// Caller must NOT hold m_mutex.
+	void CompleteSpills(std::vector<PendingSpill> &pending);
+
+	// Pick a free slot in the spill file, evicting the least-recently-used
+	// unpinned disk block once the file reaches its budget; returns
+	// m_invalid_slot when every resident block is pinned.  Caller must
+	// hold m_mutex.
+	size_t AssignSlot();
+
+	// Release one promotion's pin on a slot whose index entry was removed
+	// while the read was in flight; the last reader returns the slot to
+	// the free list.  Caller must hold m_mutex.
+	void ReleaseZombie(size_t slot);
+
+	// Returned by AssignSlot when no slot can be reclaimed.
+	static constexpr size_t m_invalid_slot{SIZE_MAX};
+
+	// Size of each slot in the spill file; matches the per-file cache
+	// entry size, so a full block always fits.
+	static constexpr size_t m_disk_slot_size = 2 * 1024 * 1024;
+
+	static std::atomic<size_t> m_max_size;
+	static std::atomic<size_t> m_disk_max_size;
+	static std::string m_disk_dir;
+
+	std::mutex m_mutex; // Protects the data structures below.
+	// LRU ordering of the cached blocks; front is most-recently-used.
+	std::list<Block> m_lru;
+	// Lookup from the combined key to the block's location in the LRU list.
+	std::unordered_map<std::string, std::list<Block>::iterator> m_blocks;
+	size_t m_size{0}; // Total bytes currently cached.
+
+	int m_disk_fd{-1};	   // Spill file descriptor; -1 unopened, -2 failed.
+	size_t m_next_slot{0}; // Next never-used slot in the spill file.
+	std::vector<size_t> m_free_slots; // Slots freed by disk-tier evictions.
+	// LRU ordering of the disk-tier blocks; front is most-recently-used.
+	std::list<DiskBlock> m_disk_lru;
+	// Lookup from the combined key to the disk block's LRU position.
+	std::unordered_map<std::string, std::list<DiskBlock>::iterator>
+		m_disk_blocks;
+	// Bumped by Invalidate(); a pending spill prepared under an older
+	// epoch may be stale and is discarded instead of indexed.
+	uint64_t m_epoch{0};
+	// Slots whose index entry was removed while promotions still had them
+	// pinned, mapped to the outstanding pin count; freed by the last
+	// reader via ReleaseZombie().
+	std::unordered_map<size_t, int> m_zombie_slots;
+};
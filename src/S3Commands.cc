@@ -18,23 +18,335 @@
 
 #include "S3Commands.hh"
 #include "AWSv4-impl.hh"
+#include "BufferPool.hh"
 #include "S3File.hh"
 #include "shortfile.hh"
 #include "stl_string_utils.hh"
 
 #include <XrdSys/XrdSysError.hh>
 #include <curl/curl.h>
+#include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <tinyxml2.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <charconv>
+#include <chrono>
 #include <cstring>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace {
+
+// An in-memory cache of the credential files.
+//
+// Reading the access/secret key from disk on every request costs a trio
+// of syscalls per file; under load, this dominates the request signing
+// path.  Contents are held in memory and invalidated when the file's
+// mtime changes, so rotated credentials are picked up without a restart.
+// The mtime itself is only re-checked every few seconds to keep stat()
+// calls off the per-request hot path.
+class S3CredentialCache {
+  public:
+	static S3CredentialCache &Instance() {
+		static S3CredentialCache instance;
+		return instance;
+	}
+
+	// Fetch the (trimmed) contents of the given credential file, returning
+	// false if the file could not be read.
+	bool Get(const std::string &fname, std::string &contents) {
+		auto now = std::chrono::steady_clock::now();
+		std::lock_guard lk(m_mutex);
+		auto iter = m_files.find(fname);
+		if (iter != m_files.end() &&
+			now - iter->second.m_last_check < m_recheck_interval) {
+			contents = iter->second.m_contents;
+			return true;
+		}
+
+		struct stat statBuf;
+		if (iter != m_files.end() && stat(fname.c_str(), &statBuf) == 0 &&
+			statBuf.st_mtime == iter->second.m_mtime) {
+			iter->second.m_last_check = now;
+			contents = iter->second.m_contents;
+			return true;
+		}
+
+		std::string newContents;
+		if (!readShortFile(fname, newContents)) {
+			m_files.erase(fname);
+			return false;
+		}
+		trim(newContents);
+		auto &entry = m_files[fname];
+		entry.m_contents = newContents;
+		entry.m_mtime = (stat(fname.c_str(), &statBuf) == 0)
+							? statBuf.st_mtime
+							: static_cast<time_t>(0);
+		entry.m_last_check = now;
+		contents = newContents;
+		return true;
+	}
+
+  private:
+	struct CredentialFile {
+		std::string m_contents;
+		time_t m_mtime{0};
+		std::chrono::steady_clock::time_point m_last_check;
+	};
+
+	std::mutex m_mutex;
+	std::unordered_map<std::string, CredentialFile> m_files;
+	static constexpr std::chrono::steady_clock::duration m_recheck_interval{
+		std::chrono::seconds(2)};
+};
+
+// Derive the AWS V4 signing key for the given secret key and credential
+// scope, memoizing the result.
+//
+// The signing key only changes when the secret key or the date-scoped
+// credential scope does (i.e., once per day), so the four-HMAC derivation
+// chain can be skipped on the hot path, leaving a single HMAC over the
+// string-to-sign per request.  The cache key includes the secret key
+// itself, so a credential rotation naturally generates a fresh entry.
+bool getV4SigningKey(const std::string &saKey, const char *date,
+					 const std::string &region, const std::string &service,
+					 unsigned char *keyOut, unsigned int *keyOutLength) {
+	static std::mutex mtx;
+	static std::unordered_map<std::string, std::vector<unsigned char>> keys;
+
+	std::string mapKey = saKey + "|" + date + "/" + region + "/" + service;
+	{
+		std::lock_guard lk(mtx);
+		auto iter = keys.find(mapKey);
+		if (iter != keys.end()) {
+			memcpy(keyOut, iter->second.data(), iter->second.size());
+			*keyOutLength = iter->second.size();
+			return true;
+		}
+	}
+
+	std::string startKey = "AWS4" + saKey;
+	unsigned char md1[EVP_MAX_MD_SIZE];
+	unsigned int md1Length = 0;
+	unsigned char md2[EVP_MAX_MD_SIZE];
+	unsigned int md2Length = 0;
+	if (HMAC(EVP_sha256(), startKey.c_str(), startKey.length(),
+			 (const unsigned char *)date, strlen(date), md1, &md1Length) ==
+		NULL) {
+		return false;
+	}
+	if (HMAC(EVP_sha256(), md1, md1Length,
+			 (const unsigned char *)region.c_str(), region.length(), md2,
+			 &md2Length) == NULL) {
+		return false;
+	}
+	if (HMAC(EVP_sha256(), md2, md2Length,
+			 (const unsigned char *)service.c_str(), service.length(), md1,
+			 &md1Length) == NULL) {
+		return false;
+	}
+	const char c[] = "aws4_request";
+	if (HMAC(EVP_sha256(), md1, md1Length, (const unsigned char *)c,
+			 sizeof(c) - 1, md2, &md2Length) == NULL) {
+		return false;
+	}
+
+	{
+		std::lock_guard lk(mtx);
+		// The cache should only ever hold a handful of entries (one per
+		// credential per day); the bound is defense-in-depth.
+		if (keys.size() > 100) {
+			keys.clear();
+		}
+		keys[mapKey] = std::vector<unsigned char>(md2, md2 + md2Length);
+	}
+	memcpy(keyOut, md2, md2Length);
+	*keyOutLength = md2Length;
+	return true;
+}
+
+// Escape the XML special characters in an object key so it can be
+// embedded in a request document.
+std::string xmlEscape(const std::string &str) {
+	std::string result;
+	result.reserve(str.size());
+	for (auto ch : str) {
+		switch (ch) {
+		case '&':
+			result += "&amp;";
+			break;
+		case '<':
+			result += "&lt;";
+			break;
+		case '>':
+			result += "&gt;";
+			break;
+		case '"':
+			result += "&quot;";
+			break;
+		default:
+			result += ch;
+		}
+	}
+	return result;
+}
+
+// Decode the predefined XML character entities (and numeric character
+// references) in an element's text.  The S3 responses only ever need
+// these, which lets the pull parser below hand back object keys without
+// first materializing a DOM.
+std::string xmlUnescape(std::string_view text) {
+	std::string result;
+	result.reserve(text.size());
+	while (!text.empty()) {
+		auto pos = text.find('&');
+		if (pos == std::string_view::npos) {
+			result.append(text);
+			break;
+		}
+		result.append(text.substr(0, pos));
+		text.remove_prefix(pos);
+		auto end = text.find(';');
+		if (end == std::string_view::npos) {
+			result.append(text);
+			break;
+		}
+		auto entity = text.substr(1, end - 1);
+		if (entity == "amp") {
+			result += '&';
+		} else if (entity == "lt") {
+			result += '<';
+		} else if (entity == "gt") {
+			result += '>';
+		} else if (entity == "quot") {
+			result += '"';
+		} else if (entity == "apos") {
+			result += '\'';
+		} else if (!entity.empty() && entity[0] == '#') {
+			uint32_t code = 0;
+			auto digits = entity.substr(1);
+			auto base = 10;
+			if (!digits.empty() && (digits[0] == 'x' || digits[0] == 'X')) {
+				digits.remove_prefix(1);
+				base = 16;
+			}
+			auto [ptr, ec] = std::from_chars(
+				digits.data(), digits.data() + digits.size(), code, base);
+			if (ec == std::errc() && ptr == digits.data() + digits.size() &&
+				code <= 0x10FFFF) {
+				// Encode the code point as UTF-8, matching tinyxml2.
+				if (code < 0x80) {
+					result += static_cast<char>(code);
+				} else if (code < 0x800) {
+					result += static_cast<char>(0xC0 | (code >> 6));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				} else if (code < 0x10000) {
+					result += static_cast<char>(0xE0 | (code >> 12));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				} else {
+					result += static_cast<char>(0xF0 | (code >> 18));
+					result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+			} else {
+				// Not a reference we understand; keep the raw text.
+				result.append(text.substr(0, end + 1));
+			}
+		} else {
+			result.append(text.substr(0, end + 1));
+		}
+		text.remove_prefix(end + 1);
+	}
+	return result;
+}
+
+// Minimal pull parser for the S3 listing responses.  The schema is fixed
+// and flat, so rather than materializing a DOM for every 1000-key page
+// the cursor walks the buffer once, handing back tags and leaf text as
+// views into the response with no per-element allocation.
+class ListXmlCursor {
+  public:
+	ListXmlCursor(std::string_view xml) : m_xml(xml) {}
+
+	// Advance to the next element tag, skipping the XML declaration and
+	// any comments.  `name` is set to the element name, `isClose` when
+	// this is a closing tag, and `isEmpty` for self-closing elements.
+	// Returns false at end-of-document.
+	bool NextTag(std::string_view &name, bool &isClose, bool &isEmpty) {
+		while (true) {
+			auto pos = m_xml.find('<', m_pos);
+			if (pos == std::string_view::npos) {
+				return false;
+			}
+			if (m_xml.compare(pos, 4, "<!--") == 0) {
+				auto end = m_xml.find("-->", pos);
+				if (end == std::string_view::npos) {
+					return false;
+				}
+				m_pos = end + 3;
+				continue;
+			}
+			if (pos + 1 < m_xml.size() &&
+				(m_xml[pos + 1] == '?' || m_xml[pos + 1] == '!')) {
+				auto end = m_xml.find('>', pos);
+				if (end == std::string_view::npos) {
+					return false;
+				}
+				m_pos = end + 1;
+				continue;
+			}
+			auto end = m_xml.find('>', pos);
+			if (end == std::string_view::npos) {
+				return false;
+			}
+			auto tagStart = pos + 1;
+			isClose = tagStart < end && m_xml[tagStart] == '/';
+			if (isClose) {
+				tagStart++;
+			}
+			auto tagEnd = tagStart;
+			while (tagEnd < end &&
+				   !isspace(static_cast<unsigned char>(m_xml[tagEnd])) &&
+				   m_xml[tagEnd] != '/') {
+				tagEnd++;
+			}
+			name = m_xml.substr(tagStart, tagEnd - tagStart);
+			isEmpty = !isClose && end > pos && m_xml[end - 1] == '/';
+			m_pos = end + 1;
+			return !name.empty();
+		}
+	}
+
+	// Return the raw text between the cursor and the next tag; entities
+	// are left encoded for the caller to decode.
+	std::string_view Text() const {
+		auto end = m_xml.find('<', m_pos);
+		if (end == std::string_view::npos) {
+			end = m_xml.size();
+		}
+		return m_xml.substr(m_pos, end - m_pos);
+	}
+
+  private:
+	std::string_view m_xml;
+	size_t m_pos{0};
+};
+
+} // namespace
 
 AmazonRequest::~AmazonRequest() {}
 
@@ -157,13 +469,12 @@ bool AmazonRequest::createV4Signature(const std::string_view payload,
 	std::string token;
 	if (!this->secretKeyFile.empty()) { // Some origins may exist in front of
 										// unauthenticated buckets
-		if (!readShortFile(this->secretKeyFile, saKey)) {
+		if (!S3CredentialCache::Instance().Get(this->secretKeyFile, saKey)) {
 			this->errorCode = "E_FILE_IO";
 			this->errorMessage = "Unable to read from secretkey file '" +
 								 this->secretKeyFile + "'.";
 			return false;
 		}
-		trim(saKey);
 	} else {
 		canonicalQueryString = canonicalizeQueryString();
 
@@ -174,13 +485,12 @@ bool AmazonRequest::createV4Signature(const std::string_view payload,
 
 	if (!this->accessKeyFile.empty()) { // Some origins may exist in front of
 										// unauthenticated buckets
-		if (!readShortFile(this->accessKeyFile, keyID)) {
+		if (!S3CredentialCache::Instance().Get(this->accessKeyFile, keyID)) {
 			this->errorCode = "E_FILE_IO";
 			this->errorMessage = "Unable to read from accesskey file '" +
 								 this->accessKeyFile + "'.";
 			return false;
 		}
-		trim(keyID);
 	} else {
 		this->errorCode = "E_FILE_IO";
 		this->errorMessage = "The secretkey file was read, but I can't read "
@@ -367,41 +677,18 @@ bool AmazonRequest::createV4Signature(const std::string_view payload,
 	// to get the security token, since they come along for free when we do.
 	//
 
-	// Task 3: calculate the signature.
-	saKey = "AWS4" + saKey;
-	const unsigned char *hmac =
-		HMAC(EVP_sha256(), saKey.c_str(), saKey.length(), (unsigned char *)d,
-			 sizeof(d) - 1, messageDigest, &mdLength);
-	if (hmac == NULL) {
-		return false;
-	}
-
-	unsigned int md2Length = 0;
-	unsigned char messageDigest2[EVP_MAX_MD_SIZE];
-	hmac = HMAC(EVP_sha256(), messageDigest, mdLength,
-				(const unsigned char *)r.c_str(), r.length(), messageDigest2,
-				&md2Length);
-	if (hmac == NULL) {
-		return false;
-	}
-
-	hmac = HMAC(EVP_sha256(), messageDigest2, md2Length,
-				(const unsigned char *)s.c_str(), s.length(), messageDigest,
-				&mdLength);
-	if (hmac == NULL) {
+	// Task 3: calculate the signature.  The date-scoped signing key is
+	// memoized, leaving a single HMAC over the string-to-sign per request.
+	unsigned char signingKey[EVP_MAX_MD_SIZE];
+	unsigned int signingKeyLength = 0;
+	if (!getV4SigningKey(saKey, d, r, s, signingKey, &signingKeyLength)) {
 		return false;
 	}
 
-	const char c[] = "aws4_request";
-	hmac = HMAC(EVP_sha256(), messageDigest, mdLength, (const unsigned char *)c,
-				sizeof(c) - 1, messageDigest2, &md2Length);
-	if (hmac == NULL) {
-		return false;
-	}
-
-	hmac = HMAC(EVP_sha256(), messageDigest2, md2Length,
-				(const unsigned char *)stringToSign.c_str(),
-				stringToSign.length(), messageDigest, &mdLength);
+	const unsigned char *hmac =
+		HMAC(EVP_sha256(), signingKey, signingKeyLength,
+			 (const unsigned char *)stringToSign.c_str(), stringToSign.length(),
+			 messageDigest, &mdLength);
 	if (hmac == NULL) {
 		return false;
 	}
@@ -475,7 +762,10 @@ bool AmazonRequest::SendS3Request(const std::string_view payload,
 	if (region.empty()) {
 		region = "us-east-1";
 	}
-	return sendV4Request(payload, payload_size, !m_streamingRequest, final,
+	// A segmented payload cannot be hashed as one contiguous buffer; send
+	// it unsigned, as is already done for the multi-chunk streaming case.
+	return sendV4Request(payload, payload_size,
+						 !m_streamingRequest && !m_payload_segments, final,
 						 blocking);
 }
 
@@ -490,11 +780,97 @@ bool AmazonS3Upload::SendRequest(const std::string_view &payload) {
 
 // ---------------------------------------------------------------------------
 
+bool AmazonS3CopyObject::SendRequest(const std::string &source) {
+	headers["x-amz-copy-source"] = source;
+	httpVerb = "PUT";
+	std::string noPayloadAllowed;
+	return SendS3Request(noPayloadAllowed, 0, true, true);
+}
+
+bool AmazonS3CopyObject::Results(std::string &errMsg) {
+	// A CopyObject request may fail after the 200 response has been
+	// committed; in that case the error document is in the body where the
+	// CopyObjectResult would otherwise be.
+	tinyxml2::XMLDocument doc;
+	auto err = doc.Parse(getResultString().c_str());
+	if (err != tinyxml2::XML_SUCCESS) {
+		errMsg = doc.ErrorStr();
+		return false;
+	}
+
+	auto elem = doc.RootElement();
+	if (!elem || strcmp(elem->Name(), "CopyObjectResult")) {
+		errMsg = "S3 CopyObject response is not rooted with CopyObjectResult "
+				 "element";
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AmazonS3CopyPart::SendRequest(const std::string &source, off_t offset,
+								   size_t size, const std::string &partNumber,
+								   const std::string &uploadId, bool blocking) {
+	query_parameters["partNumber"] = partNumber;
+	query_parameters["uploadId"] = uploadId;
+	headers["x-amz-copy-source"] = source;
+	std::string range;
+	formatstr(range, "bytes=%lld-%lld", static_cast<long long int>(offset),
+			  static_cast<long long int>(offset + size - 1));
+	headers["x-amz-copy-source-range"] = range;
+	httpVerb = "PUT";
+	std::string noPayloadAllowed;
+	return SendS3Request(noPayloadAllowed, 0, true, blocking);
+}
+
+bool AmazonS3CopyPart::GetEtag(std::string &result, std::string &errMsg) {
+	tinyxml2::XMLDocument doc;
+	auto err = doc.Parse(getResultString().c_str());
+	if (err != tinyxml2::XML_SUCCESS) {
+		errMsg = doc.ErrorStr();
+		return false;
+	}
+
+	auto elem = doc.RootElement();
+	if (!elem || strcmp(elem->Name(), "CopyPartResult")) {
+		errMsg = "S3 UploadPartCopy response is not rooted with CopyPartResult "
+				 "element";
+		return false;
+	}
+
+	for (auto child = elem->FirstChildElement(); child != nullptr;
+		 child = child->NextSiblingElement()) {
+		if (!strcmp(child->Name(), "ETag")) {
+			auto text = child->GetText();
+			result = text ? text : "";
+			// Strip the surrounding quotes for consistency with the ETag
+			// as parsed from the UploadPart response header.
+			if (result.size() >= 2 && result.front() == '"' &&
+				result.back() == '"') {
+				result = result.substr(1, result.size() - 2);
+			}
+			return !result.empty();
+		}
+	}
+	errMsg = "S3 CopyPartResult element does not include an ETag";
+	return false;
+}
+
+// ---------------------------------------------------------------------------
+
 AmazonS3CompleteMultipartUpload::~AmazonS3CompleteMultipartUpload() {}
 
 bool AmazonS3CompleteMultipartUpload::SendRequest(
 	const std::vector<std::string> &eTags, int partNumber,
 	const std::string &uploadId) {
+	return SendRequest(eTags, {}, partNumber, uploadId);
+}
+
+bool AmazonS3CompleteMultipartUpload::SendRequest(
+	const std::vector<std::string> &eTags,
+	const std::vector<std::string> &checksums, int partNumber,
+	const std::string &uploadId) {
 	query_parameters["uploadId"] = uploadId;
 
 	httpVerb = "POST";
@@ -504,6 +880,11 @@ bool AmazonS3CompleteMultipartUpload::SendRequest(
 	for (int i = 1; i < partNumber; i++) {
 		payload += "<Part>";
 		payload += "<ETag>" + eTags[i - 1] + "</ETag>";
+		if (static_cast<size_t>(i) <= checksums.size() &&
+			!checksums[i - 1].empty()) {
+			payload += "<ChecksumCRC32C>" + checksums[i - 1] +
+					   "</ChecksumCRC32C>";
+		}
 		payload += "<PartNumber>" + std::to_string(i) + "</PartNumber>";
 		payload += "</Part>";
 	}
@@ -516,23 +897,62 @@ bool AmazonS3CompleteMultipartUpload::SendRequest(
 AmazonS3CreateMultipartUpload::~AmazonS3CreateMultipartUpload() {}
 AmazonS3SendMultipartPart::~AmazonS3SendMultipartPart() {}
 
-bool AmazonS3CreateMultipartUpload::SendRequest() {
+bool AmazonS3CreateMultipartUpload::SendRequest(bool enableChecksums) {
 	query_parameters["uploads"] = "";
 	query_parameters["x-id"] = "CreateMultipartUpload";
 
+	if (enableChecksums) {
+		headers["x-amz-checksum-algorithm"] = "CRC32C";
+	}
+
 	httpVerb = "POST";
 	return SendS3Request("", 0, true, true);
 }
 
+bool AmazonS3AbortMultipartUpload::SendRequest(const std::string &uploadId) {
+	query_parameters["uploadId"] = uploadId;
+
+	httpVerb = "DELETE";
+	expectedResponseCode = 204;
+	return SendS3Request("", 0, true, true);
+}
+
 bool AmazonS3SendMultipartPart::SendRequest(const std::string_view payload,
 											const std::string &partNumber,
 											const std::string &uploadId,
-											size_t payloadSize, bool final) {
+											size_t payloadSize, bool final,
+											bool blocking) {
+	query_parameters["partNumber"] = partNumber;
+	query_parameters["uploadId"] = uploadId;
+	includeResponseHeader = true;
+	httpVerb = "PUT";
+	return SendS3Request(payload, payloadSize, final, blocking);
+}
+
+bool AmazonS3SendMultipartPart::SendRequest(const SegmentedBuffer &payload,
+											const std::string &partNumber,
+											const std::string &uploadId,
+											bool blocking) {
 	query_parameters["partNumber"] = partNumber;
 	query_parameters["uploadId"] = uploadId;
 	includeResponseHeader = true;
 	httpVerb = "PUT";
-	return SendS3Request(payload, payloadSize, final, true);
+	m_payload_segments = &payload;
+
+	// The buffer accumulated the part's CRC32C while it was being filled;
+	// attach it (big-endian, base64-encoded, per the S3 convention) so the
+	// endpoint verifies the part on receipt.
+	auto crc = payload.crc32c();
+	unsigned char crcBytes[4] = {static_cast<unsigned char>(crc >> 24),
+								 static_cast<unsigned char>(crc >> 16),
+								 static_cast<unsigned char>(crc >> 8),
+								 static_cast<unsigned char>(crc)};
+	unsigned char encoded[((sizeof(crcBytes) + 2) / 3) * 4 + 1];
+	auto encodedLength = EVP_EncodeBlock(encoded, crcBytes, sizeof(crcBytes));
+	m_checksum.assign(reinterpret_cast<char *>(encoded), encodedLength);
+	headers["x-amz-checksum-crc32c"] = m_checksum;
+
+	return SendS3Request("", payload.size(), true, blocking);
 }
 
 bool AmazonS3SendMultipartPart::GetEtag(std::string &result) {
@@ -572,6 +992,7 @@ bool AmazonS3Download::SendRequest(off_t offset, size_t size) {
 	if (size && m_buffer) {
 		m_buffer_view = std::string_view(m_buffer, size);
 	}
+	m_request_size = size;
 
 	httpVerb = "GET";
 	return SendS3Request("", 0, true, IsBlocking());
@@ -582,16 +1003,18 @@ bool AmazonS3Download::SendRequest(off_t offset, size_t size) {
 template <typename T>
 AmazonS3NonblockingDownload<T>::~AmazonS3NonblockingDownload() {}
 template class AmazonS3NonblockingDownload<S3File::S3Cache::Entry>;
+template class AmazonS3NonblockingDownload<S3File::S3Cache::PrefetchEntry>;
+template class AmazonS3NonblockingDownload<S3File::VectorReadTracker>;
 
 // ---------------------------------------------------------------------------
 
 AmazonS3Head::~AmazonS3Head() {}
 
-bool AmazonS3Head::SendRequest() {
+bool AmazonS3Head::SendRequest(bool blocking) {
 	httpVerb = "HEAD";
 	includeResponseHeader = true;
 	std::string noPayloadAllowed;
-	return SendS3Request(noPayloadAllowed, 0, true, true);
+	return SendS3Request(noPayloadAllowed, 0, true, blocking);
 }
 
 void AmazonS3Head::parseResponse() {
@@ -637,7 +1060,8 @@ void AmazonS3Head::parseResponse() {
 
 // ---------------------------------------------------------------------------
 
-bool AmazonS3List::SendRequest(const std::string &continuationToken) {
+bool AmazonS3List::SendRequest(const std::string &continuationToken,
+							   bool blocking) {
 	query_parameters["list-type"] = "2"; // Version 2 of the object-listing
 	query_parameters["delimiter"] = "/";
 	query_parameters["prefix"] = urlquote(object);
@@ -652,7 +1076,7 @@ bool AmazonS3List::SendRequest(const std::string &continuationToken) {
 	hostUrl = getProtocol() + "://" + host + bucketPath;
 	canonicalURI = bucketPath;
 
-	return SendS3Request("", 0, true, true);
+	return SendS3Request("", 0, true, blocking);
 }
 
 bool AmazonS3CreateMultipartUpload::Results(std::string &uploadId,
@@ -700,20 +1124,6 @@ bool AmazonS3CreateMultipartUpload::Results(std::string &uploadId,
 bool AmazonS3List::Results(std::vector<S3ObjectInfo> &objInfo,
 						   std::vector<std::string> &commonPrefixes,
 						   std::string &ct, std::string &errMsg) {
-	tinyxml2::XMLDocument doc;
-	auto err = doc.Parse(m_result.c_str());
-	if (err != tinyxml2::XML_SUCCESS) {
-		errMsg = doc.ErrorStr();
-		return false;
-	}
-
-	auto elem = doc.RootElement();
-	if (strcmp(elem->Name(), "ListBucketResult")) {
-		errMsg = "S3 ListBucket response is not rooted with ListBucketResult "
-				 "element";
-		return false;
-	}
-
 	// Example response from S3:
 	// <?xml version="1.0" encoding="utf-8"?>
 	// <ListBucketResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">
@@ -748,59 +1158,174 @@ bool AmazonS3List::Results(std::vector<S3ObjectInfo> &objInfo,
 	//    <Prefix>cells/muscle-ibm/endothelial-stromal-cells/metaFields/</Prefix>
 	//  </CommonPrefixes>
 	// </ListBucketResult>
+	//
+	// The schema is flat enough that the page is consumed with a single
+	// pull-parse pass over the response buffer; each 1000-key page
+	// previously cost a full tinyxml2 DOM plus a copy of every key.
+	ListXmlCursor cursor(m_result);
+	std::string_view name;
+	bool isClose, isEmpty;
+	if (!cursor.NextTag(name, isClose, isEmpty) || isClose ||
+		name != "ListBucketResult") {
+		errMsg = "S3 ListBucket response is not rooted with ListBucketResult "
+				 "element";
+		return false;
+	}
+
+	objInfo.reserve(objInfo.size() + m_maxKeys);
 	bool isTruncated = false;
-	for (auto child = elem->FirstChildElement(); child != nullptr;
-		 child = child->NextSiblingElement()) {
-		if (!strcmp(child->Name(), "IsTruncated")) {
-			bool isTrunc;
-			if (child->QueryBoolText(&isTrunc) == tinyxml2::XML_SUCCESS) {
-				isTruncated = isTrunc;
-			}
-		} else if (!strcmp(child->Name(), "CommonPrefixes")) {
-			auto prefix = child->FirstChildElement("Prefix");
-			if (prefix != nullptr) {
-				auto prefixChar = prefix->GetText();
-				if (prefixChar != nullptr) {
-					auto prefixStr = std::string(prefixChar);
-					trim(prefixStr);
-					if (!prefixStr.empty()) {
-						commonPrefixes.emplace_back(prefixStr);
-					}
+	bool rootClosed = isEmpty;
+	// The second-level container element currently open, if any.
+	enum { kNone, kContents, kCommonPrefixes } container = kNone;
+	std::string keyStr;
+	int64_t size = 0;
+	bool goodSize = false;
+	while (cursor.NextTag(name, isClose, isEmpty)) {
+		if (isClose) {
+			if (name == "Contents") {
+				if (goodSize && !keyStr.empty()) {
+					objInfo.emplace_back(S3ObjectInfo{
+						static_cast<size_t>(size), std::move(keyStr)});
 				}
+				keyStr.clear();
+				goodSize = false;
+				container = kNone;
+			} else if (name == "CommonPrefixes") {
+				container = kNone;
+			} else if (name == "ListBucketResult") {
+				rootClosed = true;
 			}
-		} else if (!strcmp(child->Name(), "Contents")) {
-			std::string keyStr;
-			int64_t size;
-			bool goodSize = false;
-			auto key = child->FirstChildElement("Key");
-			if (key != nullptr) {
-				auto keyChar = key->GetText();
-				if (keyChar != nullptr) {
-					keyStr = std::string(keyChar);
-					trim(keyStr);
-				}
+			continue;
+		}
+		if (container == kNone) {
+			if (name == "Contents") {
+				container = kContents;
+				keyStr.clear();
+				goodSize = false;
+			} else if (name == "CommonPrefixes") {
+				container = kCommonPrefixes;
+			} else if (isEmpty) {
+				continue;
+			} else if (name == "IsTruncated") {
+				auto text = cursor.Text();
+				isTruncated = (text.find("true") != std::string_view::npos ||
+							   text.find('1') != std::string_view::npos);
+			} else if (name == "NextContinuationToken") {
+				ct = xmlUnescape(cursor.Text());
+				trim(ct);
 			}
-			auto sizeElem = child->FirstChildElement("Size");
-			if (sizeElem != nullptr) {
-				goodSize =
-					(sizeElem->QueryInt64Text(&size) == tinyxml2::XML_SUCCESS);
+		} else if (container == kContents) {
+			if (isEmpty) {
+				continue;
 			}
-			if (goodSize && !keyStr.empty()) {
-				S3ObjectInfo obj;
-				obj.m_key = keyStr;
-				obj.m_size = size;
-				objInfo.emplace_back(obj);
+			if (name == "Key") {
+				keyStr = xmlUnescape(cursor.Text());
+				trim(keyStr);
+			} else if (name == "Size") {
+				auto text = cursor.Text();
+				auto start = text.find_first_not_of(" \t\r\n");
+				auto stop = text.find_last_not_of(" \t\r\n");
+				goodSize = false;
+				if (start != std::string_view::npos) {
+					auto [ptr, ec] =
+						std::from_chars(text.data() + start,
+										text.data() + stop + 1, size);
+					goodSize = (ec == std::errc() &&
+								ptr == text.data() + stop + 1);
+				}
 			}
-		} else if (!strcmp(child->Name(), "NextContinuationToken")) {
-			auto ctChar = child->GetText();
-			if (ctChar) {
-				ct = ctChar;
-				trim(ct);
+		} else { // kCommonPrefixes
+			if (isEmpty) {
+				continue;
+			}
+			if (name == "Prefix") {
+				auto prefixStr = xmlUnescape(cursor.Text());
+				trim(prefixStr);
+				if (!prefixStr.empty()) {
+					commonPrefixes.emplace_back(std::move(prefixStr));
+				}
 			}
 		}
 	}
+	if (!rootClosed) {
+		errMsg = "S3 ListBucket response is truncated";
+		return false;
+	}
 	if (!isTruncated) {
 		ct = "";
 	}
 	return true;
 }
+
+bool AmazonS3DeleteObjects::SendRequest(const std::vector<std::string> &keys,
+										bool blocking) {
+	query_parameters["delete"] = "";
+	httpVerb = "POST";
+
+	m_xml_payload =
+		"<Delete xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+		"<Quiet>true</Quiet>";
+	for (const auto &key : keys) {
+		m_xml_payload += "<Object><Key>" + xmlEscape(key) + "</Key></Object>";
+	}
+	m_xml_payload += "</Delete>";
+
+	// The DeleteObjects API requires the payload's MD5 digest alongside
+	// the usual SigV4 checksum header.
+	unsigned char md5[EVP_MAX_MD_SIZE];
+	unsigned int md5Length = 0;
+	if (!EVP_Digest(m_xml_payload.data(), m_xml_payload.size(), md5,
+					&md5Length, EVP_md5(), nullptr)) {
+		errorCode = "E_INTERNAL";
+		errorMessage = "Failed to compute the MD5 of the delete payload";
+		return false;
+	}
+	unsigned char encoded[((EVP_MAX_MD_SIZE + 2) / 3) * 4 + 1];
+	auto encodedLength = EVP_EncodeBlock(encoded, md5, md5Length);
+	headers["Content-MD5"] =
+		std::string(reinterpret_cast<char *>(encoded), encodedLength);
+
+	// Operation is on the bucket itself; alter the URL to remove the object
+	hostUrl = getProtocol() + "://" + host + bucketPath;
+	canonicalURI = bucketPath;
+
+	return SendS3Request(m_xml_payload, m_xml_payload.size(), true, blocking);
+}
+
+bool AmazonS3DeleteObjects::Results(
+	std::vector<std::pair<std::string, std::string>> &errors,
+	std::string &errMsg) {
+	tinyxml2::XMLDocument doc;
+	auto err = doc.Parse(getResultString().c_str());
+	if (err != tinyxml2::XML_SUCCESS) {
+		errMsg = doc.ErrorStr();
+		return false;
+	}
+
+	auto elem = doc.RootElement();
+	if (strcmp(elem->Name(), "DeleteResult")) {
+		errMsg = "S3 DeleteObjects response is not rooted with DeleteResult "
+				 "element";
+		return false;
+	}
+
+	// In quiet mode, the response only carries an <Error> element for
+	// each key that failed to delete.
+	for (auto child = elem->FirstChildElement(); child != nullptr;
+		 child = child->NextSiblingElement()) {
+		if (strcmp(child->Name(), "Error")) {
+			continue;
+		}
+		std::string key, message;
+		auto keyElem = child->FirstChildElement("Key");
+		if (keyElem != nullptr && keyElem->GetText() != nullptr) {
+			key = keyElem->GetText();
+		}
+		auto msgElem = child->FirstChildElement("Message");
+		if (msgElem != nullptr && msgElem->GetText() != nullptr) {
+			message = msgElem->GetText();
+		}
+		errors.emplace_back(key, message);
+	}
+	return true;
+}
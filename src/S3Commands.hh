@@ -23,6 +23,7 @@
 
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 // The base class for all requests to the S3 endpoint.
@@ -114,6 +115,13 @@ class AmazonRequest : public HTTPRequest {
 	bool sendV4Request(const std::string_view payload, off_t payload_size,
 					   bool sendContentSHA, bool final, bool blocking);
 
+	// Compute the AWS V4 signature over the given payload and fill in the
+	// Authorization header to attach to the request.  Protected (rather
+	// than private) so the benchmark suite can measure it in isolation.
+	bool createV4Signature(const std::string_view payload,
+						   std::string &authorizationHeader,
+						   bool sendContentSHA = false);
+
 	bool retainObject;
 	bool m_streamingRequest{
 		false}; // Is this a streaming request?  Streaming requests will not
@@ -139,10 +147,6 @@ class AmazonRequest : public HTTPRequest {
 	std::string m_style;
 
   private:
-	bool createV4Signature(const std::string_view payload,
-						   std::string &authorizationHeader,
-						   bool sendContentSHA = false);
-
 	std::string canonicalizeQueryString();
 };
 
@@ -164,10 +168,36 @@ class AmazonS3Upload final : public AmazonRequest {
 
 	bool SendRequest(const std::string_view &payload);
 
+	RequestLane getLane() const override { return RequestLane::Bulk; }
+
   protected:
 	std::string path;
 };
 
+// Server-side copy of an object via the S3 CopyObject API.
+//
+// The bytes never leave the S3 backend; the gateway only issues the
+// control request.  Limited by S3 to sources of at most 5GB -- larger
+// objects must be copied with AmazonS3CopyPart.
+class AmazonS3CopyObject final : public AmazonRequest {
+	using AmazonRequest::SendRequest;
+
+  public:
+	AmazonS3CopyObject(const S3AccessInfo &ai, const std::string &objectName,
+					   XrdSysError &log)
+		: AmazonRequest(ai, objectName, log) {}
+
+	virtual ~AmazonS3CopyObject() {}
+
+	// Copy the given source (formatted as `bucket/object`) into this
+	// request's object.
+	bool SendRequest(const std::string &source);
+
+	// Verify the copy succeeded; S3 may return a 200 response whose body
+	// carries an error document.
+	bool Results(std::string &errMsg);
+};
+
 class AmazonS3CreateMultipartUpload final : public AmazonRequest {
 	using AmazonRequest::SendRequest;
 
@@ -187,7 +217,10 @@ class AmazonS3CreateMultipartUpload final : public AmazonRequest {
 
 	virtual ~AmazonS3CreateMultipartUpload();
 
-	virtual bool SendRequest();
+	// Create the multipart upload.  If `enableChecksums` is set, declare
+	// CRC32C as the upload's checksum algorithm; every subsequent part must
+	// then carry a `x-amz-checksum-crc32c` header for S3 to verify.
+	virtual bool SendRequest(bool enableChecksums = false);
 
   protected:
 	// std::string path;
@@ -214,9 +247,33 @@ class AmazonS3CompleteMultipartUpload : public AmazonRequest {
 	virtual bool SendRequest(const std::vector<std::string> &eTags,
 							 int partNumber, const std::string &uploadId);
 
+	// Variant carrying the per-part CRC32C checksums (base64-encoded, as
+	// sent in the parts' `x-amz-checksum-crc32c` headers); S3 verifies each
+	// against the checksum it stored when the part was uploaded.  Entries
+	// may be empty for uploads whose parts carried no checksum.
+	bool SendRequest(const std::vector<std::string> &eTags,
+					 const std::vector<std::string> &checksums, int partNumber,
+					 const std::string &uploadId);
+
   protected:
 };
 
+// Abort an in-progress multipart upload, discarding its uploaded parts;
+// used by the reaper that cleans up uploads whose client never returned.
+class AmazonS3AbortMultipartUpload final : public AmazonRequest {
+	using AmazonRequest::SendRequest;
+
+  public:
+	AmazonS3AbortMultipartUpload(const S3AccessInfo &ai,
+								 const std::string &objectName,
+								 XrdSysError &log)
+		: AmazonRequest(ai, objectName, log) {}
+
+	virtual ~AmazonS3AbortMultipartUpload() {}
+
+	bool SendRequest(const std::string &uploadId);
+};
+
 class AmazonS3SendMultipartPart : public AmazonRequest {
 	using AmazonRequest::SendRequest;
 
@@ -243,15 +300,77 @@ class AmazonS3SendMultipartPart : public AmazonRequest {
 	// - uploadId: The upload ID assigned by the creation of the multipart
 	// upload
 	// - final: Set to true if this is the last of the part; false otherwise
+	// - blocking: If false, hand the payload to the worker pool and return
+	// without waiting for the part's response; the caller must keep the
+	// payload alive and later invoke `WaitForCompletion` before reading
+	// the ETag.
 	bool SendRequest(const std::string_view payload,
 					 const std::string &partNumber, const std::string &uploadId,
-					 size_t payloadSize, bool final);
+					 size_t payloadSize, bool final, bool blocking = true);
+
+	// Send a complete part whose payload lives in a pooled segmented buffer.
+	// The buffer is walked by the curl read callback without a coalescing
+	// copy; the caller must keep it alive until the request completes.
+	//
+	// - payload: The segmented buffer holding the part's contents.
+	// - partNumber: The portion of the multipart upload.
+	// - uploadId: The upload ID assigned by the creation of the multipart
+	// upload
+	// - blocking: As for the contiguous variant of SendRequest.
+	bool SendRequest(const SegmentedBuffer &payload,
+					 const std::string &partNumber, const std::string &uploadId,
+					 bool blocking = true);
 
 	// Retrieve the ETag header from the returned headers;
 	bool GetEtag(std::string &result);
 
+	// The part's base64-encoded CRC32C checksum, as sent in its
+	// `x-amz-checksum-crc32c` header; empty if the part carried no
+	// checksum (only the pooled-buffer variant of SendRequest sets one).
+	const std::string &GetChecksum() const { return m_checksum; }
+
+	RequestLane getLane() const override { return RequestLane::Bulk; }
+
   private:
 	std::string m_etag;
+	std::string m_checksum;
+};
+
+// Server-side copy of a byte range of an object into one part of a
+// multipart upload, via the S3 UploadPartCopy API.
+//
+// Used for renames of objects larger than the 5GB CopyObject limit;
+// many ranges may be kept in flight on the curl worker pool at once.
+class AmazonS3CopyPart final : public AmazonRequest {
+	using AmazonRequest::SendRequest;
+
+  public:
+	AmazonS3CopyPart(const S3AccessInfo &ai, const std::string &objectName,
+					 XrdSysError &log)
+		: AmazonRequest(ai, objectName, log) {}
+
+	virtual ~AmazonS3CopyPart() {}
+
+	// Copy `size` bytes at `offset` of the given source (formatted as
+	// `bucket/object`) into the part.
+	//
+	// - source: The source bucket and object to copy from.
+	// - offset: Offset of the beginning of the range to copy.
+	// - size: Size of the range to copy.
+	// - partNumber: The portion of the multipart upload.
+	// - uploadId: The upload ID assigned by the creation of the multipart
+	// upload.
+	// - blocking: If false, hand the request to the worker pool and return
+	// without waiting for the response; the caller must invoke
+	// `WaitForCompletion` before reading the ETag.
+	bool SendRequest(const std::string &source, off_t offset, size_t size,
+					 const std::string &partNumber, const std::string &uploadId,
+					 bool blocking = true);
+
+	// Retrieve the part's ETag from the CopyPartResult response body (the
+	// UploadPartCopy API, unlike UploadPart, does not return it as a
+	// header).
+	bool GetEtag(std::string &result, std::string &errMsg);
 };
 
 class AmazonS3Download : public AmazonRequest {
@@ -272,12 +391,24 @@ class AmazonS3Download : public AmazonRequest {
 
 	virtual bool SendRequest(off_t offset, size_t size);
 
+	// A request for the entire object (size zero) is of unknown length and
+	// is treated as bulk.
+	RequestLane getLane() const override {
+		return m_request_size && m_request_size <= m_small_read_max
+				   ? RequestLane::SmallRead
+				   : RequestLane::Bulk;
+	}
+
   protected:
 	virtual bool IsBlocking() { return true; }
 	virtual std::string_view *requestResult() override {
 		return &m_buffer_view;
 	}
 
+	// Size of the requested range, recorded when the request is sent; used
+	// to pick between the small-read and bulk lanes.
+	size_t m_request_size{0};
+
   private:
 	char *m_buffer{nullptr};
 	std::string_view m_buffer_view;
@@ -318,7 +449,10 @@ class AmazonS3Head final : public AmazonRequest {
 
 	virtual ~AmazonS3Head();
 
-	virtual bool SendRequest();
+	// Send the HEAD request; when `blocking` is false, the request is
+	// handed to the curl worker pool and the caller must collect it via
+	// `WaitForCompletion` before inspecting the response.
+	virtual bool SendRequest(bool blocking = true);
 
 	off_t getSize() {
 		parseResponse();
@@ -342,7 +476,7 @@ struct S3ObjectInfo {
 	std::string m_key;
 };
 
-class AmazonS3List final : public AmazonRequest {
+class AmazonS3List : public AmazonRequest {
 	using AmazonRequest::SendRequest;
 
   public:
@@ -352,7 +486,11 @@ class AmazonS3List final : public AmazonRequest {
 
 	virtual ~AmazonS3List() {}
 
-	bool SendRequest(const std::string &continuationToken);
+	// Send the listing request; when `blocking` is false, the request is
+	// handed to the curl worker pool and the caller must collect it via
+	// `WaitForCompletion` before invoking `Results`.
+	bool SendRequest(const std::string &continuationToken,
+					 bool blocking = true);
 	bool Results(std::vector<S3ObjectInfo> &objInfo,
 				 std::vector<std::string> &commonPrefixes, std::string &ct,
 				 std::string &errMsg);
@@ -360,3 +498,40 @@ class AmazonS3List final : public AmazonRequest {
   private:
 	size_t m_maxKeys{1000};
 };
+
+// Batch deletion of objects via the S3 DeleteObjects API.
+//
+// Deletes up to 1000 keys with a single POST against the bucket; the
+// recursive unlink path uses this so that tearing down a large
+// pseudo-directory does not cost one round trip per object.
+class AmazonS3DeleteObjects final : public AmazonRequest {
+	using AmazonRequest::SendRequest;
+
+  public:
+	AmazonS3DeleteObjects(const S3AccessInfo &ai, XrdSysError &log)
+		: AmazonRequest(ai, "", log, false) {}
+
+	virtual ~AmazonS3DeleteObjects() {}
+
+	// Issue the batch delete for the given keys (at most `m_max_keys`).
+	//
+	// - keys: The object keys to delete, relative to the bucket.
+	// - blocking: If false, hand the request to the worker pool and return
+	// without waiting for the response; the caller must later invoke
+	// `WaitForCompletion` before reading the results.
+	bool SendRequest(const std::vector<std::string> &keys,
+					 bool blocking = true);
+
+	// Parse the response, filling `errors` with any key the endpoint
+	// failed to delete paired with the endpoint's failure message.
+	bool Results(std::vector<std::pair<std::string, std::string>> &errors,
+				 std::string &errMsg);
+
+	// The largest batch the DeleteObjects API accepts in one request.
+	static constexpr size_t m_max_keys = 1000;
+
+  private:
+	// The request's XML document; kept as a member so a non-blocking send
+	// has a stable payload to read from.
+	std::string m_xml_payload;
+};
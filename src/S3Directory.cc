@@ -28,6 +28,12 @@
 #include <sstream>
 
 void S3Directory::Reset() {
+	if (m_next_page) {
+		// The curl workers still reference the in-flight request; collect
+		// it before tearing the state down.
+		m_next_page->WaitForCompletion();
+		m_next_page.reset();
+	}
 	m_opened = false;
 	m_ct = "";
 	m_idx = 0;
@@ -36,13 +42,25 @@ void S3Directory::Reset() {
 	m_stat_buf = nullptr;
 	m_ai = S3AccessInfo();
 	m_object = "";
+	m_listing_key = "";
+	m_cached.reset();
+	m_accum.reset();
 }
 
 int S3Directory::ListS3Dir(const std::string &ct) {
-	AmazonS3List listCommand(m_ai, m_object, 1000, m_log);
-	auto res = listCommand.SendRequest(ct);
+	std::unique_ptr<AmazonS3List> listCommand;
+	bool res;
+	if (m_next_page) {
+		// The page was requested while the previous one was being drained;
+		// collect its response.
+		listCommand = std::move(m_next_page);
+		res = listCommand->WaitForCompletion();
+	} else {
+		listCommand.reset(new AmazonS3List(m_ai, m_object, 1000, m_log));
+		res = listCommand->SendRequest(ct);
+	}
 	if (!res) {
-		switch (listCommand.getResponseCode()) {
+		switch (listCommand->getResponseCode()) {
 		case 404:
 			return -ENOENT;
 		case 500:
@@ -55,7 +73,7 @@ int S3Directory::ListS3Dir(const std::string &ct) {
 	}
 	std::string errMsg;
 	m_idx = 0;
-	res = listCommand.Results(m_objInfo, m_commonPrefixes, m_ct, errMsg);
+	res = listCommand->Results(m_objInfo, m_commonPrefixes, m_ct, errMsg);
 	if (!res) {
 		m_log.Log(XrdHTTPServer::Warning, "Opendir",
 				  "Failed to parse S3 results:", errMsg.c_str());
@@ -68,6 +86,34 @@ int S3Directory::ListS3Dir(const std::string &ct) {
 		m_log.Log(XrdHTTPServer::Debug, "Stat", ss.str().c_str());
 	}
 
+	// Accumulate the pages so the completed listing can be shared with
+	// subsequent opens of the same prefix.
+	if (m_accum) {
+		m_accum->m_objects.insert(m_accum->m_objects.end(), m_objInfo.begin(),
+								  m_objInfo.end());
+		m_accum->m_common_prefixes.insert(m_accum->m_common_prefixes.end(),
+										  m_commonPrefixes.begin(),
+										  m_commonPrefixes.end());
+		if (m_accum->ApproxSize() > S3ListingCache::GetCacheSize() / 2) {
+			// The listing has outgrown the cache's budget; stop hoarding.
+			m_accum.reset();
+		} else if (m_ct.empty()) {
+			S3ListingCache::Instance().Put(
+				m_listing_key,
+				std::shared_ptr<const S3ListingCache::Listing>(
+					std::move(m_accum)));
+		}
+	}
+
+	// Start fetching the next page while the consumer drains this one.
+	if (!m_ct.empty()) {
+		m_next_page.reset(new AmazonS3List(m_ai, m_object, 1000, m_log));
+		if (!m_next_page->SendRequest(m_ct, false)) {
+			// Fall back to a blocking fetch when the page is needed.
+			m_next_page.reset();
+		}
+	}
+
 	m_opened = true;
 	return 0;
 }
@@ -107,6 +153,17 @@ int S3Directory::Opendir(const char *path, XrdOucEnv &env) {
 	}
 	m_object = object;
 
+	// Serve a recent listing of the same prefix straight from memory when
+	// one is available.
+	m_listing_key = m_ai.getS3ServiceUrl() + "/" + m_ai.getS3BucketName() +
+					"/" + m_object;
+	if ((m_cached = S3ListingCache::Instance().Get(m_listing_key))) {
+		m_idx = 0;
+		m_opened = true;
+		return 0;
+	}
+
+	m_accum.reset(new S3ListingCache::Listing());
 	return ListS3Dir("");
 }
 
@@ -132,13 +189,20 @@ int S3Directory::Readdir(char *buff, int blen) {
 	// If all the paths entry have been consumed, then if the continuation token
 	// is set, list more objects in the bucket.  If it's unset, then we've
 	// iterated through all the bucket contents.
+	// When a cached listing is being served, read from the shared vectors
+	// instead of the per-handle ones; the pagination branches below are
+	// never entered in that case as the continuation token is empty.
+	const auto &objInfo = m_cached ? m_cached->m_objects : m_objInfo;
+	const auto &commonPrefixes =
+		m_cached ? m_cached->m_common_prefixes : m_commonPrefixes;
+
 	auto idx = m_idx;
-	if (m_objInfo.empty() && m_commonPrefixes.empty()) {
+	if (objInfo.empty() && commonPrefixes.empty()) {
 		*buff = '\0';
 		return XrdOssOK;
-	} else if (idx >= 0 && idx < static_cast<ssize_t>(m_objInfo.size())) {
+	} else if (idx >= 0 && idx < static_cast<ssize_t>(objInfo.size())) {
 		m_idx++;
-		std::string full_name = m_objInfo[idx].m_key;
+		std::string full_name = objInfo[idx].m_key;
 		auto lastSlashIdx = full_name.rfind("/");
 		if (lastSlashIdx != std::string::npos) {
 			full_name.erase(0, lastSlashIdx);
@@ -152,10 +216,10 @@ int S3Directory::Readdir(char *buff, int blen) {
 		if (m_stat_buf) {
 			m_stat_buf->st_mode = 0x0600 | S_IFREG;
 			m_stat_buf->st_nlink = 1;
-			m_stat_buf->st_size = m_objInfo[idx].m_size;
+			m_stat_buf->st_size = objInfo[idx].m_size;
 		}
 	} else if (idx < 0 &&
-			   -idx == static_cast<ssize_t>(m_commonPrefixes.size())) {
+			   -idx == static_cast<ssize_t>(commonPrefixes.size())) {
 		if (!m_ct.empty()) {
 			// Get the next set of results from S3.
 			m_idx = 0;
@@ -174,9 +238,9 @@ int S3Directory::Readdir(char *buff, int blen) {
 		}
 		*buff = '\0';
 		return XrdOssOK;
-	} else if (idx == static_cast<ssize_t>(m_objInfo.size()) ||
-			   -idx < static_cast<ssize_t>(m_commonPrefixes.size())) {
-		if (m_commonPrefixes.empty()) {
+	} else if (idx == static_cast<ssize_t>(objInfo.size()) ||
+			   -idx < static_cast<ssize_t>(commonPrefixes.size())) {
+		if (commonPrefixes.empty()) {
 			if (!m_ct.empty()) {
 				// Get the next set of results from S3.
 				m_idx = 0;
@@ -196,14 +260,14 @@ int S3Directory::Readdir(char *buff, int blen) {
 			*buff = '\0';
 			return XrdOssOK;
 		}
-		if (idx == static_cast<ssize_t>(m_objInfo.size())) {
+		if (idx == static_cast<ssize_t>(objInfo.size())) {
 			m_idx = -1;
 			idx = 0;
 		} else {
 			idx = -m_idx;
 			m_idx--;
 		}
-		std::string full_name = m_commonPrefixes[idx];
+		std::string full_name = commonPrefixes[idx];
 		trimslashes(full_name);
 		auto lastSlashIdx = full_name.rfind("/");
 		if (lastSlashIdx != std::string::npos) {
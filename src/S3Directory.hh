@@ -21,7 +21,9 @@
 #include "HTTPDirectory.hh"
 #include "S3Commands.hh"
 #include "S3FileSystem.hh"
+#include "S3ListingCache.hh"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -32,7 +34,7 @@ class S3Directory : public HTTPDirectory {
 	S3Directory(XrdSysError &log, const S3FileSystem &fs)
 		: HTTPDirectory(log), m_fs(fs) {}
 
-	virtual ~S3Directory() {}
+	virtual ~S3Directory() { Reset(); }
 
 	virtual int Opendir(const char *path, XrdOucEnv &env) override;
 
@@ -56,4 +58,16 @@ class S3Directory : public HTTPDirectory {
 	const S3FileSystem &m_fs;
 	S3AccessInfo m_ai;
 	struct stat *m_stat_buf{nullptr};
+	// The next page's listing request, issued to the curl worker pool
+	// while the consumer drains the current page; Readdir then only
+	// blocks on the first page of a large listing.
+	std::unique_ptr<AmazonS3List> m_next_page;
+	// Listing cache key for the prefix (endpoint, bucket and prefix).
+	std::string m_listing_key;
+	// A cached listing being served in place of m_objInfo and
+	// m_commonPrefixes; shared with other handles listing the prefix.
+	std::shared_ptr<const S3ListingCache::Listing> m_cached;
+	// A fresh listing being accumulated across pages for insertion into
+	// the cache; dropped if the listing outgrows the cache's budget.
+	std::shared_ptr<S3ListingCache::Listing> m_accum;
 };
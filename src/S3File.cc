@@ -18,15 +18,22 @@
 
 #include "S3File.hh"
 #include "CurlWorker.hh"
+#include "S3BlockCache.hh"
 #include "S3Commands.hh"
 #include "S3FileSystem.hh"
+#include "S3ListingCache.hh"
+#include "S3StatCache.hh"
+#include "TransferStats.hh"
+#include "UploadJournal.hh"
 #include "logging.hh"
 #include "stl_string_utils.hh"
 
+#include <XrdOuc/XrdOucCRC.hh>
 #include <XrdOuc/XrdOucEnv.hh>
 #include <XrdOuc/XrdOucStream.hh>
 #include <XrdSec/XrdSecEntity.hh>
 #include <XrdSec/XrdSecEntityAttr.hh>
+#include <XrdSfs/XrdSfsAio.hh>
 #include <XrdSfs/XrdSfsInterface.hh>
 #include <XrdVersion.hh>
 
@@ -34,8 +41,8 @@
 
 #include <algorithm>
 #include <charconv>
+#include <cstring>
 #include <filesystem>
-#include <iostream>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -43,7 +50,6 @@
 #include <stdlib.h>
 #include <string>
 #include <string_view>
-#include <thread>
 #include <vector>
 
 using namespace XrdHTTPServer;
@@ -52,16 +58,42 @@ S3FileSystem *g_s3_oss = nullptr;
 
 XrdVERSIONINFO(XrdOssGetFileSystem, S3);
 
-std::vector<std::pair<std::weak_ptr<std::mutex>,
-					  std::weak_ptr<AmazonS3SendMultipartPart>>>
-	S3File::m_pending_ops;
-std::mutex S3File::m_pending_lk;
-std::once_flag S3File::m_monitor_launch;
-
 S3File::S3File(XrdSysError &log, S3FileSystem *oss)
 	: m_log(log), m_oss(oss), content_length(0), last_modified(0),
 	  partNumber(1) {}
 
+S3File::~S3File() {
+	// If the handle is torn down with part uploads still in flight, the curl
+	// workers may yet reference the payload buffers owned by the pipeline;
+	// wait for each outstanding part before releasing them.
+	for (auto &part : m_inflight_parts) {
+		part.m_op->WaitForCompletion();
+	}
+	// Asynchronous reads reference the client's buffers and the cache
+	// entries; wait for any still in flight before tearing either down.
+	m_cache.DrainAioReads();
+	// Similarly, readahead downloads reference buffers owned by the cache.
+	m_cache.DrainPrefetches();
+
+	// Fold this handle's cache counters into the process-wide statistics;
+	// they are otherwise lost when the handle is destroyed.
+	TransferStats::CacheSample sample;
+	sample.m_hit_bytes = m_cache.m_hit_bytes;
+	sample.m_miss_bytes = m_cache.m_miss_bytes;
+	sample.m_full_hit_count = m_cache.m_full_hit_count;
+	sample.m_partial_hit_count = m_cache.m_partial_hit_count;
+	sample.m_miss_count = m_cache.m_miss_count;
+	sample.m_bypass_bytes = m_cache.m_bypass_bytes;
+	sample.m_bypass_count = m_cache.m_bypass_count;
+	sample.m_fetch_bytes = m_cache.m_fetch_bytes;
+	sample.m_fetch_count = m_cache.m_fetch_count;
+	sample.m_unused_bytes = m_cache.m_unused_bytes;
+	sample.m_prefetch_bytes = m_cache.m_prefetch_bytes;
+	sample.m_prefetch_count = m_cache.m_prefetch_count;
+	sample.m_errors = m_cache.m_errors;
+	TransferStats::Instance().AddCacheStats(sample);
+}
+
 int S3File::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &env) {
 	if (Oflag & O_CREAT) {
 		m_log.Log(LogMask::Info, "Open", "File opened for creation:", path);
@@ -110,6 +142,51 @@ int S3File::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &env) {
 
 	m_ai = *ai;
 	m_object = object;
+	m_exposed_path = exposedPath;
+	m_cache_key =
+		m_ai.getS3ServiceUrl() + "/" + m_ai.getS3BucketName() + "/" + m_object;
+	m_pipeline_depth = m_oss->getPartPipelineDepth();
+	m_prefetch_max_blocks = m_oss->getPrefetchBlocks();
+
+	// Choose the part size for a potential multipart upload, targeting at
+	// most m_max_part_count parts when the final object size is known.
+	m_upload_part_size = m_oss->getPartSizeMin();
+	if (m_object_size > 0) {
+		auto target = static_cast<size_t>(
+			(m_object_size + static_cast<off_t>(m_max_part_count) - 1) /
+			static_cast<off_t>(m_max_part_count));
+		if (target > m_upload_part_size) {
+			m_upload_part_size = target;
+		}
+	}
+	if (m_upload_part_size > m_oss->getPartSizeMax()) {
+		m_upload_part_size = m_oss->getPartSizeMax();
+	}
+
+	// A dropped connection mid-upload leaves a journaled multipart upload
+	// behind; an append re-open picks it up and resumes from the last
+	// completed part rather than restarting from byte zero.  Note the
+	// incomplete object does not yet exist, so the existence check below
+	// must be skipped.
+	if ((Oflag & O_APPEND) && m_write_lk && UploadJournal::Enabled()) {
+		UploadJournal::State state;
+		if (UploadJournal::Load(exposedPath, m_object, state)) {
+			uploadId = state.m_uploadId;
+			eTags = std::move(state.m_eTags);
+			// Restore the per-part checksums alongside the ETags; the
+			// completion XML pairs the two by index, so a checksummed
+			// upload resumed without these would misattribute the
+			// post-resume parts' checksums and be rejected at Close.
+			m_part_checksums = std::move(state.m_checksums);
+			partNumber = eTags.size() + 1;
+			m_write_offset = state.m_committed;
+			m_journal_committed = state.m_committed;
+			m_log.Log(LogMask::Info, "Open",
+					  "Resuming interrupted multipart upload at offset",
+					  std::to_string(m_write_offset).c_str());
+			return 0;
+		}
+	}
 
 	// This flag is not set when it's going to be a read operation
 	// so we check if the file exists in order to be able to return a 404
@@ -127,37 +204,215 @@ ssize_t S3File::Read(void *buffer, off_t offset, size_t size) {
 	return m_cache.Read(*this, static_cast<char *>(buffer), offset, size);
 }
 
-int S3File::Fstat(struct stat *buff) {
-	AmazonS3Head head(m_ai, m_object, m_log);
+ssize_t S3File::pgRead(void *buffer, off_t offset, size_t rdlen,
+					   uint32_t *csvec, uint64_t opts) {
+	auto rv = Read(buffer, offset, rdlen);
+	if (rv < 0) {
+		return rv;
+	}
+	if (csvec) {
+		// Compute the per-page CRC32C checksums over the filled buffer;
+		// XrdOucCRC uses the SSE4.2/ARMv8 CRC instructions when available.
+		// The checksums cover the pages of the request buffer, which the
+		// cache assembles from (potentially several) downloaded blocks, so
+		// they are computed here rather than inside the download callback.
+		XrdOucCRC::Calc32C(buffer, rv, csvec);
+	}
+	return rv;
+}
 
-	if (!head.SendRequest()) {
-		auto httpCode = head.getResponseCode();
-		if (httpCode) {
-			std::stringstream ss;
-			ss << "HEAD command failed: " << head.getResponseCode() << ": "
-			   << head.getResultString();
-			m_log.Log(LogMask::Warning, "S3ile::Fstat", ss.str().c_str());
-			switch (httpCode) {
-			case 404:
-				return -ENOENT;
-			case 500:
-				return -EIO;
-			case 403:
-				return -EPERM;
-			default:
-				return -EIO;
+int S3File::Read(XrdSfsAio *aiop) {
+	auto buffer =
+		reinterpret_cast<char *>(const_cast<void *>(aiop->sfsAio.aio_buf));
+	off_t offset = aiop->sfsAio.aio_offset;
+	size_t size = aiop->sfsAio.aio_nbytes;
+
+	// Requests larger than a cache entry would bypass the cache entirely;
+	// service those through the blocking path and complete inline rather
+	// than teaching the bypass download about continuations.
+	if (size > m_cache_entry_size) {
+		aiop->Result = Read(buffer, offset, size);
+		aiop->doneRead();
+		return 0;
+	}
+	return m_cache.ReadAio(*this, aiop);
+}
+
+void S3File::VectorReadTracker::Notify() {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_outstanding--;
+	m_cv.notify_one();
+}
+
+void S3File::VectorReadTracker::Wait() {
+	std::unique_lock<std::mutex> lk(m_mutex);
+	m_cv.wait(lk, [&] { return m_outstanding == 0; });
+}
+
+ssize_t S3File::ReadV(XrdOucIOVec *readV, int rdvcnt) {
+	if (rdvcnt < 0) {
+		return -EINVAL;
+	}
+	ssize_t total_size = 0;
+	for (int idx = 0; idx < rdvcnt; idx++) {
+		if (readV[idx].size < 0) {
+			return -EINVAL;
+		}
+		// Mirror the semantics of the serial fallback: a fragment that
+		// cannot be fully satisfied fails the entire vector read.
+		if (static_cast<off_t>(readV[idx].offset) +
+				static_cast<off_t>(readV[idx].size) >
+			content_length) {
+			return -ESPIPE;
+		}
+		total_size += readV[idx].size;
+	}
+	if (!total_size) {
+		return 0;
+	}
+	if (rdvcnt == 1) {
+		return Read(readV[0].data, readV[0].offset, readV[0].size);
+	}
+
+	// Sort the fragments by offset, then coalesce fragments separated by
+	// less than m_readv_gap_size into a single ranged GET (bounded by
+	// m_readv_max_range_size so one request cannot balloon in memory).
+	std::vector<int> frag_order(rdvcnt);
+	for (int idx = 0; idx < rdvcnt; idx++) {
+		frag_order[idx] = idx;
+	}
+	std::sort(frag_order.begin(), frag_order.end(), [&](int left, int right) {
+		return readV[left].offset < readV[right].offset;
+	});
+
+	std::vector<VectorReadRange> ranges;
+	for (auto frag : frag_order) {
+		auto frag_off = static_cast<off_t>(readV[frag].offset);
+		auto frag_size = static_cast<size_t>(readV[frag].size);
+		if (!frag_size) {
+			continue;
+		}
+		auto frag_end = frag_off + static_cast<off_t>(frag_size);
+		if (!ranges.empty()) {
+			auto &range = ranges.back();
+			auto range_end = range.m_off + static_cast<off_t>(range.m_size);
+			auto new_end = std::max(frag_end, range_end);
+			if (frag_off <=
+					range_end + static_cast<off_t>(m_readv_gap_size) &&
+				static_cast<size_t>(new_end - range.m_off) <=
+					m_readv_max_range_size) {
+				range.m_size = new_end - range.m_off;
+				range.m_fragments.push_back(frag);
+				continue;
 			}
-		} else {
+		}
+		ranges.emplace_back();
+		auto &range = ranges.back();
+		range.m_off = frag_off;
+		range.m_size = frag_size;
+		range.m_fragments.push_back(frag);
+	}
+
+	if (m_log.getMsgMask() & LogMask::Debug) {
+		std::stringstream ss;
+		ss << "Issuing vector read of " << rdvcnt << " fragments ("
+		   << total_size << " bytes) as " << ranges.size()
+		   << " ranged GET(s)";
+		m_log.Log(LogMask::Debug, "ReadV", ss.str().c_str());
+	}
+
+	// Issue the ranged GETs concurrently through the worker pool, then
+	// wait for all of them to complete.
+	VectorReadTracker tracker;
+	tracker.m_outstanding = static_cast<int>(ranges.size());
+	bool failed = false;
+	for (auto &range : ranges) {
+		range.m_buffer.resize(range.m_size);
+		range.m_request.reset(new AmazonS3NonblockingDownload<VectorReadTracker>(
+			m_ai, m_object, m_log, range.m_buffer.data(), tracker));
+		if (!range.m_request->SendRequest(range.m_off, range.m_size)) {
+			m_log.Log(LogMask::Warning, "ReadV",
+					  "Failed to issue download request:",
+					  range.m_request->getErrorMessage().c_str());
+			range.m_request.reset();
+			failed = true;
+			std::lock_guard<std::mutex> lk(tracker.m_mutex);
+			tracker.m_outstanding--;
+		}
+	}
+	tracker.Wait();
+	if (failed) {
+		return -EIO;
+	}
+	for (auto &range : ranges) {
+		if (!range.m_request->getErrorCode().empty() ||
+			range.m_request->getResponseCode() != 206) {
 			std::stringstream ss;
-			ss << "Failed to send HEAD command: " << head.getErrorCode() << ": "
-			   << head.getErrorMessage();
-			m_log.Log(LogMask::Warning, "S3File::Fstat", ss.str().c_str());
+			ss << "Failed to download range at offset=" << range.m_off
+			   << ", size=" << range.m_size << "; response code "
+			   << range.m_request->getResponseCode();
+			m_log.Log(LogMask::Warning, "ReadV", ss.str().c_str());
 			return -EIO;
 		}
 	}
 
-	content_length = head.getSize();
-	last_modified = head.getLastModified();
+	// Scatter the downloaded ranges back into the caller's fragments.
+	for (auto &range : ranges) {
+		for (auto frag : range.m_fragments) {
+			memcpy(readV[frag].data,
+				   range.m_buffer.data() +
+					   (static_cast<off_t>(readV[frag].offset) - range.m_off),
+				   readV[frag].size);
+		}
+	}
+	return total_size;
+}
+
+int S3File::Fstat(struct stat *buff) {
+	S3StatCache::ObjectInfo info;
+	if (S3StatCache::Instance().Get(m_cache_key, info)) {
+		if (info.m_response_code == 404) {
+			return -ENOENT;
+		}
+		content_length = info.m_size;
+		last_modified = info.m_last_modified;
+	} else {
+		AmazonS3Head head(m_ai, m_object, m_log);
+
+		if (!head.SendRequest()) {
+			auto httpCode = head.getResponseCode();
+			if (httpCode) {
+				std::stringstream ss;
+				ss << "HEAD command failed: " << head.getResponseCode() << ": "
+				   << head.getResultString();
+				m_log.Log(LogMask::Warning, "S3ile::Fstat", ss.str().c_str());
+				switch (httpCode) {
+				case 404:
+					info.m_response_code = 404;
+					S3StatCache::Instance().Put(m_cache_key, info);
+					return -ENOENT;
+				case 500:
+					return -EIO;
+				case 403:
+					return -EPERM;
+				default:
+					return -EIO;
+				}
+			} else {
+				std::stringstream ss;
+				ss << "Failed to send HEAD command: " << head.getErrorCode()
+				   << ": " << head.getErrorMessage();
+				m_log.Log(LogMask::Warning, "S3File::Fstat", ss.str().c_str());
+				return -EIO;
+			}
+		}
+
+		content_length = head.getSize();
+		last_modified = head.getLastModified();
+		info.m_size = content_length;
+		info.m_last_modified = last_modified;
+		S3StatCache::Instance().Put(m_cache_key, info);
+	}
 
 	if (buff) {
 		memset(buff, '\0', sizeof(struct stat));
@@ -181,11 +436,12 @@ ssize_t S3File::Write(const void *buffer, off_t offset, size_t size) {
 	if (!write_mutex) {
 		return -EBADF;
 	}
-	std::lock_guard lk(*write_mutex);
+	std::unique_lock lk(*write_mutex);
 
 	// Small object optimization -- if this is the full object, upload
 	// it immediately.
-	if (!m_write_offset && m_object_size == static_cast<off_t>(size)) {
+	if (!m_write_offset && m_object_size == static_cast<off_t>(size) &&
+		m_reorder_buffers.empty()) {
 		AmazonS3Upload upload(m_ai, m_object, m_log);
 		m_write_lk.reset();
 		if (!upload.SendRequest(
@@ -198,31 +454,104 @@ ssize_t S3File::Write(const void *buffer, off_t offset, size_t size) {
 			m_log.Log(LogMask::Debug, "Write",
 					  "Creation of small object succeeded",
 					  std::to_string(size).c_str());
+			S3BlockCache::Instance().Invalidate(m_cache_key);
+			S3StatCache::Instance().Invalidate(m_cache_key);
+			S3ListingCache::Instance().Invalidate(
+				m_cache_key.substr(0, m_cache_key.rfind('/') + 1));
 			return size;
 		}
 	}
 
-	if (offset != m_write_offset) {
-		m_log.Emsg(
-			"Write",
-			"Out-of-order write detected; S3 requires writes to be in order");
-		m_write_offset = -1;
-		return -EIO;
+	while (offset != m_write_offset) {
+		if (m_write_offset == -1) {
+			// Previous I/O error has occurred.  File is in bad state,
+			// immediately fail.
+			return -EIO;
+		}
+		if (offset < m_write_offset) {
+			m_log.Emsg("Write", "Out-of-order write detected; data before the "
+								"write pointer cannot be resent to S3");
+			m_write_offset = -1;
+			m_reorder_cv.notify_all();
+			return -EIO;
+		}
+		// The write landed ahead of the write pointer -- likely a parallel
+		// client stream delivering segments out of order.  Buffer it in the
+		// reordering window until the writes before it arrive.
+		auto window_max = m_reorder_window_parts * m_upload_part_size;
+		if (size > window_max) {
+			m_log.Emsg("Write", "Out-of-order write is larger than the "
+								"reordering window; failing the upload");
+			m_write_offset = -1;
+			m_reorder_cv.notify_all();
+			return -EIO;
+		}
+		if (m_reorder_bytes + size <= window_max) {
+			// Reject segments that overlap data already buffered; S3 offers
+			// no way to rewrite bytes once they are sent.
+			auto iter = m_reorder_buffers.upper_bound(offset);
+			auto overlap = iter != m_reorder_buffers.end() &&
+						   offset + static_cast<off_t>(size) > iter->first;
+			if (iter != m_reorder_buffers.begin()) {
+				auto prev = std::prev(iter);
+				overlap |=
+					prev->first + static_cast<off_t>(prev->second.size()) >
+					offset;
+			}
+			if (overlap) {
+				m_log.Emsg("Write", "Out-of-order write overlaps a "
+									"previously-buffered segment");
+				m_write_offset = -1;
+				m_reorder_cv.notify_all();
+				return -EIO;
+			}
+			SegmentedBuffer segment;
+			segment.append(
+				std::string_view(static_cast<const char *>(buffer), size));
+			m_reorder_buffers.emplace_hint(iter, offset, std::move(segment));
+			m_reorder_bytes += size;
+			return size;
+		}
+		// The window is full; wait for the in-order stream to advance.  The
+		// writer filling the gap at the write pointer never waits here, so
+		// the upload always makes progress.
+		m_reorder_cv.wait(lk);
 	}
-	if (m_write_offset == -1) {
-		// Previous I/O error has occurred.  File is in bad state, immediately
-		// fail.
-		return -EIO;
+
+	auto rv = WriteInOrder(buffer, offset, size);
+	if (rv < 0) {
+		m_reorder_cv.notify_all();
+		return rv;
+	}
+
+	// The bytes just written may have filled the gap ahead of buffered
+	// out-of-order segments; feed any whose turn has arrived into the
+	// upload pipeline.
+	if (!m_reorder_buffers.empty()) {
+		auto drain_rv = DrainReorderWindow();
+		if (drain_rv < 0) {
+			return drain_rv;
+		}
 	}
+	return rv;
+}
+
+ssize_t S3File::WriteInOrder(const void *buffer, off_t offset, size_t size) {
 	if (uploadId == "") {
 		AmazonS3CreateMultipartUpload startUpload(m_ai, m_object, m_log);
-		if (!startUpload.SendRequest()) {
+		// Streaming writes buffer each part in full before dispatch, so the
+		// part's CRC32C is known (accumulated during buffering) by the time
+		// its headers go out; declare the algorithm so S3 verifies every
+		// part on receipt.  When the object size is known, parts stream out
+		// ahead of their checksum and must stay unchecked.
+		if (!startUpload.SendRequest(m_object_size == -1)) {
 			m_log.Emsg("Write", "S3 multipart request failed");
 			m_write_offset = -1;
 			return -ENOENT;
 		}
 		std::string errMsg;
 		startUpload.Results(uploadId, errMsg);
+		UploadJournal::Start(m_exposed_path, m_object, uploadId);
 	}
 
 	// If we don't know the final object size, we must use the streaming
@@ -249,13 +578,9 @@ ssize_t S3File::Write(const void *buffer, off_t offset, size_t size) {
 		}
 
 		m_write_op.reset(new AmazonS3SendMultipartPart(m_ai, m_object, m_log));
-		{
-			std::lock_guard lk(m_pending_lk);
-			m_pending_ops.emplace_back(m_write_lk, m_write_op);
-		}
 
 		// Calculate the size of the current chunk, if it's known.
-		m_part_size = m_s3_part_size;
+		m_part_size = m_upload_part_size;
 		if (!m_object_size) {
 			m_part_size = 0;
 		} else if (m_write_offset + static_cast<off_t>(m_part_size) >
@@ -266,39 +591,80 @@ ssize_t S3File::Write(const void *buffer, off_t offset, size_t size) {
 	return written;
 }
 
+ssize_t S3File::DrainReorderWindow() {
+	while (!m_reorder_buffers.empty() &&
+		   m_reorder_buffers.begin()->first == m_write_offset) {
+		auto iter = m_reorder_buffers.begin();
+		auto segment = std::move(iter->second);
+		m_reorder_buffers.erase(iter);
+		// Feed the segment through a pooled scratch buffer; the upload
+		// pipeline takes its own copy of the bytes it keeps in flight.
+		auto scratch = BufferPool::Instance().Acquire();
+		ssize_t rv = 0;
+		size_t consumed = 0;
+		while (consumed < segment.size()) {
+			auto chunk =
+				segment.copyOut(scratch.data(), consumed, scratch.size());
+			rv = WriteInOrder(scratch.data(), m_write_offset, chunk);
+			if (rv < 0) {
+				break;
+			}
+			consumed += chunk;
+		}
+		m_reorder_bytes -= segment.size();
+		segment.clear();
+		BufferPool::Instance().Release(std::move(scratch));
+		m_reorder_cv.notify_all();
+		if (rv < 0) {
+			return rv;
+		}
+	}
+	return 0;
+}
+
 ssize_t S3File::WriteStreaming(const void *buffer, off_t offset, size_t size) {
 	m_streaming_buffer.append(
 		std::string_view(static_cast<const char *>(buffer), size));
 	m_write_offset += size;
 
 	ssize_t rv = size;
-	if (m_streaming_buffer.size() > 100'000'000) {
+	if (m_streaming_buffer.size() > m_upload_part_size) {
 		rv = SendPartStreaming();
 	}
 	return rv;
 }
 
 ssize_t S3File::SendPartStreaming() {
-	int length = m_streaming_buffer.length();
-	AmazonS3SendMultipartPart upload_part_request =
-		AmazonS3SendMultipartPart(m_ai, m_object, m_log);
-	if (!upload_part_request.SendRequest(m_streaming_buffer,
-										 std::to_string(partNumber), uploadId,
-										 m_streaming_buffer.size(), true)) {
+	int length = m_streaming_buffer.size();
+	auto upload_part_request =
+		std::make_shared<AmazonS3SendMultipartPart>(m_ai, m_object, m_log);
+	// Move the buffered part's segments into the pipeline and hand them to
+	// the worker pool; the ETag is harvested later, overlapping the upload
+	// with the buffering of subsequent parts.
+	m_inflight_parts.emplace_back(InflightPart{
+		upload_part_request, std::string(), std::move(m_streaming_buffer)});
+	auto &part = m_inflight_parts.back();
+	part.m_size = length;
+	if (!part.m_op->SendRequest(part.m_segments, std::to_string(partNumber),
+								uploadId, false)) {
 		m_log.Log(LogMask::Debug, "SendPart", "upload.SendRequest() failed");
+		m_inflight_parts.pop_back();
 		return -EIO;
-	} else {
-		m_log.Log(LogMask::Debug, "SendPart", "upload.SendRequest() succeeded");
-		std::string etag;
-		if (!upload_part_request.GetEtag(etag)) {
-			m_log.Log(
-				LogMask::Debug, "SendPart",
-				"upload.SendRequest() response missing an eTag in response");
-			return -EIO;
+	}
+	m_log.Log(LogMask::Debug, "SendPart", "upload.SendRequest() dispatched");
+	partNumber++;
+	// With the final object size unknown, grow the part size geometrically
+	// so arbitrarily long streams stay under the part-count target without
+	// inflating the buffering for small uploads.
+	if (partNumber % m_part_growth_interval == 0) {
+		m_upload_part_size =
+			std::min(m_upload_part_size * 2, m_oss->getPartSizeMax());
+	}
+	while (m_inflight_parts.size() >= m_pipeline_depth) {
+		auto rv = HarvestOldestPart();
+		if (rv < 0) {
+			return rv;
 		}
-		eTags.push_back(etag);
-		partNumber++;
-		m_streaming_buffer.clear();
 	}
 
 	return length;
@@ -307,21 +673,58 @@ ssize_t S3File::SendPartStreaming() {
 ssize_t S3File::ContinueSendPart(const void *buffer, size_t size) {
 	m_part_written += size;
 	auto write_size = size;
-	if (m_part_written > m_s3_part_size) {
-		write_size = size - (m_part_written - m_s3_part_size);
-		m_part_written = m_s3_part_size;
+	if (m_part_written > m_upload_part_size) {
+		write_size = size - (m_part_written - m_upload_part_size);
+		m_part_written = m_upload_part_size;
 	}
 	auto is_final = (m_part_size > 0 && m_part_written == m_part_size) ||
-					m_part_written == m_s3_part_size;
+					m_part_written == m_upload_part_size;
 	if (m_log.getMsgMask() & LogMask::Debug) {
 		std::stringstream ss;
 		ss << "Sending request with buffer of size=" << write_size
 		   << ", offset=" << m_write_offset << " and is_final=" << is_final;
 		m_log.Log(LogMask::Debug, "ContinueSendPart", ss.str().c_str());
 	}
-	if (!m_write_op->SendRequest(
-			std::string_view(static_cast<const char *>(buffer), write_size),
-			std::to_string(partNumber), uploadId, m_object_size, is_final)) {
+	if (is_final) {
+		// Hand the final chunk of the part to the worker pool without
+		// waiting for the part's response.  The bytes are copied into the
+		// pipeline entry so the caller may immediately reuse its buffer;
+		// the ETag is harvested once the pipeline fills or the file closes.
+		m_inflight_parts.emplace_back(
+			InflightPart{std::move(m_write_op), std::string()});
+		auto &part = m_inflight_parts.back();
+		part.m_size = m_part_written;
+		if (write_size) {
+			part.m_buffer.assign(static_cast<const char *>(buffer),
+								 write_size);
+		}
+		if (!part.m_op->SendRequest(part.m_buffer, std::to_string(partNumber),
+									uploadId, m_object_size, true, false)) {
+			m_write_offset = -1;
+			if (part.m_op->getErrorCode() == "E_TIMEOUT") {
+				m_log.Emsg("Write", "Timeout when uploading to S3");
+				m_inflight_parts.pop_back();
+				return -ETIMEDOUT;
+			}
+			m_log.Emsg("Write", "Upload to S3 failed: ",
+					   part.m_op->getErrorMessage().c_str());
+			m_inflight_parts.pop_back();
+			return -EIO;
+		}
+		m_part_written = 0;
+		m_part_size = 0;
+		partNumber++;
+		while (m_inflight_parts.size() >= m_pipeline_depth) {
+			auto rv = HarvestOldestPart();
+			if (rv < 0) {
+				return rv;
+			}
+		}
+	} else if (!m_write_op->SendRequest(
+				   std::string_view(static_cast<const char *>(buffer),
+									write_size),
+				   std::to_string(partNumber), uploadId, m_object_size,
+				   false)) {
 		m_write_offset = -1;
 		if (m_write_op->getErrorCode() == "E_TIMEOUT") {
 			m_log.Emsg("Write", "Timeout when uploading to S3");
@@ -333,83 +736,49 @@ ssize_t S3File::ContinueSendPart(const void *buffer, size_t size) {
 		m_write_op.reset();
 		return -EIO;
 	}
-	if (is_final) {
-		m_part_written = 0;
-		m_part_size = 0;
-		std::string etag;
-		if (!m_write_op->GetEtag(etag)) {
-			m_log.Emsg("Write", "Result from S3 does not include ETag");
-			m_write_op.reset();
-			m_write_offset = -1;
-			return -EIO;
-		}
-		eTags.push_back(etag);
-		m_write_op.reset();
-		partNumber++;
-	}
 
 	return write_size;
 }
 
-void S3File::LaunchMonitorThread() {
-	std::call_once(m_monitor_launch, [] {
-		std::thread t(S3File::CleanupTransfers);
-		t.detach();
-	});
-}
-
-void S3File::CleanupTransfers() {
-	while (true) {
-		std::this_thread::sleep_for(HTTPRequest::GetStallTimeout() / 3);
-		try {
-			CleanupTransfersOnce();
-		} catch (std::exception &exc) {
-			std::cerr << "Warning: caught unexpected exception when trying to "
-						 "clean transfers: "
-					  << exc.what() << std::endl;
+ssize_t S3File::HarvestOldestPart() {
+	if (m_inflight_parts.empty()) {
+		return 0;
+	}
+	auto part = std::move(m_inflight_parts.front());
+	m_inflight_parts.pop_front();
+	if (!part.m_op->WaitForCompletion()) {
+		m_write_offset = -1;
+		if (part.m_op->getErrorCode() == "E_TIMEOUT") {
+			m_log.Emsg("Write", "Timeout when uploading to S3");
+			return -ETIMEDOUT;
 		}
+		m_log.Emsg("Write", "Upload to S3 failed: ",
+				   part.m_op->getErrorMessage().c_str());
+		return -EIO;
+	}
+	std::string etag;
+	if (!part.m_op->GetEtag(etag)) {
+		m_log.Emsg("Write", "Result from S3 does not include ETag");
+		m_write_offset = -1;
+		return -EIO;
 	}
+	eTags.push_back(etag);
+	m_part_checksums.push_back(part.m_op->GetChecksum());
+	m_journal_committed += part.m_size;
+	UploadJournal::RecordPart(m_exposed_path, m_object, eTags.size(),
+							  m_journal_committed, etag,
+							  part.m_op->GetChecksum());
+	return 0;
 }
 
-void S3File::CleanupTransfersOnce() {
-	// Make a list of live transfers; erase any dead ones still on the list.
-	std::vector<std::pair<std::shared_ptr<std::mutex>,
-						  std::shared_ptr<AmazonS3SendMultipartPart>>>
-		existing_ops;
-	{
-		std::lock_guard lk(m_pending_lk);
-		existing_ops.reserve(m_pending_ops.size());
-		m_pending_ops.erase(
-			std::remove_if(m_pending_ops.begin(), m_pending_ops.end(),
-						   [&](const auto &op) -> bool {
-							   auto op_lk = op.first.lock();
-							   if (!op_lk) {
-								   // In this case, the S3File is no longer open
-								   // for write.  No need to potentially clean
-								   // up the transfer.
-								   return true;
-							   }
-							   auto op_part = op.second.lock();
-							   if (!op_part) {
-								   // In this case, the S3File object is still
-								   // open for writes but the upload has
-								   // completed. Remove from the list.
-								   return true;
-							   }
-							   // The S3File is open and upload is in-progress;
-							   // we'll tick the transfer.
-							   existing_ops.emplace_back(op_lk, op_part);
-							   return false;
-						   }),
-			m_pending_ops.end());
-	}
-	// For each live transfer, call `Tick` to advance the clock and possibly
-	// time things out.
-	auto now = std::chrono::steady_clock::now();
-	for (auto &info : existing_ops) {
-		std::lock_guard lk(*info.first);
-		info.second->Tick(now);
+ssize_t S3File::DrainPartPipeline() {
+	while (!m_inflight_parts.empty()) {
+		auto rv = HarvestOldestPart();
+		if (rv < 0) {
+			return rv;
+		}
 	}
+	return 0;
 }
 
 int S3File::Close(long long *retsz) {
@@ -424,11 +793,21 @@ int S3File::Close(long long *retsz) {
 		} else {
 			m_log.Log(LogMask::Debug, "Close",
 					  "Creation of zero-length object succeeded");
+			S3BlockCache::Instance().Invalidate(m_cache_key);
+			S3StatCache::Instance().Invalidate(m_cache_key);
+			S3ListingCache::Instance().Invalidate(
+				m_cache_key.substr(0, m_cache_key.rfind('/') + 1));
 			return 0;
 		}
 	}
 	if (m_write_lk) {
 		std::lock_guard lk(*m_write_lk);
+		if (!m_reorder_buffers.empty()) {
+			m_log.Emsg("Close", "Closing file with out-of-order segments still "
+								"buffered; a gap in the stream was never "
+								"written");
+			return -EIO;
+		}
 		if (m_object_size == -1 && !m_streaming_buffer.empty()) {
 			m_log.Emsg("Close", "Sending final part of length",
 					   std::to_string(m_streaming_buffer.size()).c_str());
@@ -445,6 +824,14 @@ int S3File::Close(long long *retsz) {
 				return -EIO;
 			}
 		}
+		// Collect the ETags for any part uploads still in flight before
+		// the multipart upload can be completed.
+		auto rv = DrainPartPipeline();
+		if (rv < 0) {
+			m_log.Log(LogMask::Warning, "Close",
+					  "Failed to complete an in-flight S3 upload part");
+			return rv;
+		}
 	}
 
 	// this is only true if some parts have been written and need to be
@@ -452,11 +839,17 @@ int S3File::Close(long long *retsz) {
 	if (partNumber > 1) {
 		AmazonS3CompleteMultipartUpload complete_upload_request =
 			AmazonS3CompleteMultipartUpload(m_ai, m_object, m_log);
-		if (!complete_upload_request.SendRequest(eTags, partNumber, uploadId)) {
+		if (!complete_upload_request.SendRequest(eTags, m_part_checksums,
+												 partNumber, uploadId)) {
 			m_log.Emsg("SendPart", "close.SendRequest() failed");
 			return -ENOENT;
 		} else {
 			m_log.Emsg("SendPart", "close.SendRequest() succeeded");
+			UploadJournal::Finish(m_exposed_path, m_object);
+			S3BlockCache::Instance().Invalidate(m_cache_key);
+			S3StatCache::Instance().Invalidate(m_cache_key);
+			S3ListingCache::Instance().Invalidate(
+				m_cache_key.substr(0, m_cache_key.rfind('/') + 1));
 		}
 	}
 
@@ -536,14 +929,68 @@ S3File::DownloadBypass(off_t offset, size_t size, char *buffer) {
 	if (size <= m_cache_entry_size) {
 		return std::make_tuple(offset, size, false);
 	}
-	AmazonS3Download download(m_ai, m_object, m_log, buffer);
-	if (!download.SendRequest(offset, size)) {
-		std::stringstream ss;
-		ss << "Failed to send GetObject command: " << download.getResponseCode()
-		   << "'" << download.getResultString() << "'";
-		m_log.Log(LogMask::Warning, "S3File::Read", ss.str().c_str());
+
+	// Scale the number of concurrent sub-range GETs with the request size
+	// -- one stream per `m_bypass_stripe_size` bytes, bounded by the
+	// configured cap -- since per-connection throughput to the endpoint
+	// saturates well below what several streams can aggregate.
+	auto streams =
+		std::min<size_t>((size + m_bypass_stripe_size - 1) / m_bypass_stripe_size,
+						 m_oss->getBypassStreams());
+	if (streams <= 1) {
+		AmazonS3Download download(m_ai, m_object, m_log, buffer);
+		if (!download.SendRequest(offset, size)) {
+			std::stringstream ss;
+			ss << "Failed to send GetObject command: "
+			   << download.getResponseCode() << "'"
+			   << download.getResultString() << "'";
+			m_log.Log(LogMask::Warning, "S3File::Read", ss.str().c_str());
+			return std::make_tuple(0, -1, false);
+		}
+		return std::make_tuple(-1, 0, true);
+	}
+
+	// Each stream writes directly into its slice of the caller's buffer;
+	// the disjoint offsets make the scatter zero-copy and lock-free.
+	auto stripe = (size + streams - 1) / streams;
+	std::vector<std::unique_ptr<AmazonS3NonblockingDownload<VectorReadTracker>>>
+		requests;
+	requests.reserve(streams);
+	VectorReadTracker tracker;
+	bool failed = false;
+	for (size_t done = 0; done < size; done += stripe) {
+		auto slice_size = std::min(stripe, size - done);
+		requests.emplace_back(new AmazonS3NonblockingDownload<VectorReadTracker>(
+			m_ai, m_object, m_log, buffer + done, tracker));
+		{
+			std::lock_guard<std::mutex> lk(tracker.m_mutex);
+			tracker.m_outstanding++;
+		}
+		if (!requests.back()->SendRequest(offset + done, slice_size)) {
+			m_log.Log(LogMask::Warning, "S3File::Read",
+					  "Failed to issue download request:",
+					  requests.back()->getErrorMessage().c_str());
+			requests.back().reset();
+			failed = true;
+			std::lock_guard<std::mutex> lk(tracker.m_mutex);
+			tracker.m_outstanding--;
+		}
+	}
+	tracker.Wait();
+	if (failed) {
 		return std::make_tuple(0, -1, false);
 	}
+	for (auto &request : requests) {
+		if (!request->getErrorCode().empty() ||
+			request->getResponseCode() != 206) {
+			std::stringstream ss;
+			ss << "Failed to send GetObject command: "
+			   << request->getResponseCode() << "'"
+			   << request->getResultString() << "'";
+			m_log.Log(LogMask::Warning, "S3File::Read", ss.str().c_str());
+			return std::make_tuple(0, -1, false);
+		}
+	}
 	return std::make_tuple(-1, 0, true);
 }
 
@@ -600,6 +1047,10 @@ ssize_t S3File::S3Cache::Read(S3File &file, char *buffer, off_t offset,
 		file.m_log.Log(LogMask::Debug, "cache", ss.str().c_str());
 	}
 
+	// Advance the sequential-stream detector and issue any readahead the
+	// current window allows.
+	Prefetch(file, offset, size);
+
 	off_t req3_off, req4_off, req5_off, req6_off;
 	size_t req3_size, req4_size, req5_size, req6_size;
 	// Copy as much data out of the cache as possible; wait for the caches to
@@ -956,18 +1407,352 @@ ssize_t S3File::S3Cache::Read(S3File &file, char *buffer, off_t offset,
 	return size;
 }
 
+int S3File::S3Cache::ReadAio(S3File &file, XrdSfsAio *aiop) {
+	auto buffer =
+		reinterpret_cast<char *>(const_cast<void *>(aiop->sfsAio.aio_buf));
+	off_t offset = aiop->sfsAio.aio_offset;
+	size_t size = aiop->sfsAio.aio_nbytes;
+
+	if (offset >= file.content_length) {
+		aiop->Result = 0;
+		aiop->doneRead();
+		return 0;
+	}
+	if (offset + static_cast<off_t>(size) > file.content_length) {
+		size = file.content_length - offset;
+	}
+	if (file.m_log.getMsgMask() & LogMask::Debug) {
+		std::stringstream ss;
+		ss << "Async read request for offset=" << offset << ", size=" << size;
+		file.m_log.Log(LogMask::Debug, "cache", ss.str().c_str());
+	}
+
+	// Advance the sequential-stream detector exactly as the blocking path
+	// does; asynchronous streams benefit from readahead all the same.
+	Prefetch(file, offset, size);
+
+	auto aio = std::make_unique<AioRead>();
+	aio->m_aiop = aiop;
+	aio->m_file = &file;
+	aio->m_buffer = buffer;
+	aio->m_base_off = offset;
+	aio->m_total = size;
+	aio->m_off = offset;
+	aio->m_size = size;
+	// Split the request on the cache-entry boundary so that each sub-range
+	// lies within a single aligned block.
+	auto chunk_off = static_cast<off_t>(
+		offset / m_cache_entry_size * m_cache_entry_size + m_cache_entry_size);
+	if (offset + static_cast<off_t>(size) > chunk_off) {
+		aio->m_size = chunk_off - offset;
+		aio->m_off2 = chunk_off;
+		aio->m_size2 = offset + size - chunk_off;
+	}
+
+	std::vector<std::pair<XrdSfsAio *, ssize_t>> completed;
+	{
+		std::unique_lock lk(m_mutex);
+		m_aio_reads.push_back(std::move(aio));
+		ProgressAioReads(completed);
+
+		// Account for the request: if it's still queued, the missing bytes
+		// are a miss; if it finished inline, it was served from the cache.
+		size_t miss_bytes = 0;
+		auto pending = false;
+		for (const auto &req : m_aio_reads) {
+			if (req->m_aiop == aiop) {
+				pending = true;
+				miss_bytes = req->m_size + req->m_size2;
+			}
+		}
+		if (pending) {
+			if (miss_bytes == size) {
+				m_miss_count += 1;
+			} else {
+				m_partial_hit_count += 1;
+			}
+			m_miss_bytes += miss_bytes;
+		} else {
+			for (const auto &req : completed) {
+				if (req.first == aiop && req.second >= 0) {
+					m_full_hit_count += 1;
+				}
+			}
+		}
+	}
+	// The completion callbacks may re-enter with a follow-up read; invoke
+	// them only once the cache mutex has been dropped.
+	for (auto &req : completed) {
+		req.first->Result = req.second;
+		req.first->doneRead();
+	}
+	return 0;
+}
+
+int S3File::S3Cache::TryServeAio(AioRead &aio) {
+	for (auto entry : {&m_a, &m_b}) {
+		if (entry->m_inprogress) {
+			continue;
+		}
+		if (CouldUseAligned(aio.m_off, entry->m_off) ||
+			CouldUseAligned(aio.m_off2, entry->m_off)) {
+			if (entry->m_failed) {
+				entry->m_failed = false;
+				entry->m_off = -1;
+				m_errors += 1;
+				return -1;
+			}
+		}
+		// Each sub-range lies within a single aligned block, so a matching
+		// entry serves it completely.
+		if (CouldUseAligned(aio.m_off, entry->m_off)) {
+			entry->OverlapCopy(aio.m_off, aio.m_size,
+							   aio.m_buffer + (aio.m_off - aio.m_base_off));
+			aio.m_off = -1;
+			aio.m_size = 0;
+		}
+		if (CouldUseAligned(aio.m_off2, entry->m_off)) {
+			entry->OverlapCopy(aio.m_off2, aio.m_size2,
+							   aio.m_buffer + (aio.m_off2 - aio.m_base_off));
+			aio.m_off2 = -1;
+			aio.m_size2 = 0;
+		}
+	}
+	return (aio.m_off == -1 && aio.m_off2 == -1) ? 1 : 0;
+}
+
+bool S3File::S3Cache::ScheduleAioDownloads(AioRead &aio) {
+	auto inline_done = false;
+	bool claimed_a = false, claimed_b = false;
+	for (auto off : {aio.m_off, aio.m_off2}) {
+		if (off == -1) {
+			continue;
+		}
+		auto aligned = off / static_cast<off_t>(m_cache_entry_size) *
+					   static_cast<off_t>(m_cache_entry_size);
+		if ((m_a.m_inprogress && m_a.m_off == aligned) ||
+			(m_b.m_inprogress && m_b.m_off == aligned)) {
+			// The needed block is already being fetched.
+			continue;
+		}
+		Entry *idle = nullptr;
+		if (!m_a.m_inprogress && !claimed_a) {
+			idle = &m_a;
+			claimed_a = true;
+		} else if (!m_b.m_inprogress && !claimed_b) {
+			idle = &m_b;
+			claimed_b = true;
+		} else {
+			// Both entries are busy; the request is advanced again when one
+			// of the outstanding downloads notifies.
+			continue;
+		}
+		if (idle->m_off != -1) {
+			auto bytes_unused = static_cast<ssize_t>(m_cache_entry_size) -
+								static_cast<ssize_t>(idle->m_used);
+			m_unused_bytes += bytes_unused < 0 ? 0 : bytes_unused;
+		}
+		idle->m_off = aligned;
+		idle->m_inprogress = true;
+		m_fetch_count += 1;
+		m_fetch_bytes += m_cache_entry_size;
+		idle->Download(*aio.m_file);
+		if (!idle->m_inprogress) {
+			// Served inline from the shared block cache; another serve pass
+			// can make progress immediately.
+			inline_done = true;
+		}
+	}
+	return inline_done;
+}
+
+void S3File::S3Cache::ProgressAioReads(
+	std::vector<std::pair<XrdSfsAio *, ssize_t>> &completed) {
+	auto progress = true;
+	while (progress) {
+		progress = false;
+		for (auto it = m_aio_reads.begin(); it != m_aio_reads.end();) {
+			auto &aio = **it;
+			auto rv = TryServeAio(aio);
+			if (rv != 0) {
+				completed.emplace_back(aio.m_aiop,
+									   rv < 0 ? -1
+											  : static_cast<ssize_t>(
+													aio.m_total));
+				it = m_aio_reads.erase(it);
+				progress = true;
+				continue;
+			}
+			if (ScheduleAioDownloads(aio)) {
+				progress = true;
+			}
+			++it;
+		}
+	}
+}
+
+void S3File::S3Cache::DrainAioReads() {
+	std::unique_lock lk(m_mutex);
+	m_cv.wait(lk, [&] {
+		return m_aio_reads.empty() && !m_a.m_inprogress && !m_b.m_inprogress;
+	});
+}
+
 void S3File::S3Cache::Entry::Notify() {
+	auto failed = !m_request->getErrorCode().empty();
+	if (!failed) {
+		// Publish the downloaded block so other file handles reading the
+		// same object can avoid the round-trip to S3.  While the entry is
+		// in-progress, no other thread touches m_data, so the copy is safe
+		// to make before re-acquiring the cache mutex.
+		S3BlockCache::Instance().Put(
+			m_cache_key, m_off,
+			std::make_shared<std::vector<char>>(
+				m_data.data(), m_data.data() + m_cache_entry_size));
+	}
+
+	std::vector<std::pair<XrdSfsAio *, ssize_t>> completed;
+	{
+		std::unique_lock lk(m_parent.m_mutex);
+		m_inprogress = false;
+		m_failed = failed;
+		m_request = nullptr;
+
+		// Advance any asynchronous reads waiting on this download before
+		// waking blocked readers.
+		m_parent.ProgressAioReads(completed);
+		m_parent.m_cv.notify_all();
+	}
+	// The completion callbacks may re-enter with a follow-up read; invoke
+	// them only once the cache mutex has been dropped.
+	for (auto &req : completed) {
+		req.first->Result = req.second;
+		req.first->doneRead();
+	}
+}
+
+void S3File::S3Cache::PrefetchEntry::Notify() {
+	if (m_request->getErrorCode().empty()) {
+		S3BlockCache::Instance().Put(
+			m_cache_key, m_off,
+			std::make_shared<std::vector<char>>(std::move(m_data)));
+	}
+
 	std::unique_lock lk(m_parent.m_mutex);
-	m_inprogress = false;
-	m_failed = !m_request->getErrorCode().empty();
+	m_done = true;
 	m_request = nullptr;
 
 	m_parent.m_cv.notify_all();
 }
 
+void S3File::S3Cache::Prefetch(S3File &file, off_t offset, size_t size) {
+	auto max_window = file.m_prefetch_max_blocks;
+	if (!max_window) {
+		return;
+	}
+
+	std::unique_lock lk(m_mutex);
+	// Reap any readahead downloads that have since completed.
+	m_prefetches.remove_if([](const auto &entry) { return entry->m_done; });
+
+	if (offset == m_next_seq_off || (offset == 0 && m_next_seq_off == -1)) {
+		m_seq_streak++;
+		if (m_seq_streak >= m_min_window) {
+			// Ramp the window up exponentially toward the configured max.
+			m_prefetch_window =
+				m_prefetch_window
+					? std::min(m_prefetch_window * 2, max_window)
+					: m_min_window;
+		}
+	} else {
+		// Random access: drop the readahead back to zero and restart the
+		// detector from the current read.
+		m_seq_streak = 1;
+		m_prefetch_window = 0;
+		m_prefetch_next = -1;
+	}
+	m_next_seq_off = offset + static_cast<off_t>(size);
+	if (!m_prefetch_window) {
+		return;
+	}
+
+	// Start the readahead cursor past both the current read and the blocks
+	// the double-buffer entries already cover, so we do not duplicate their
+	// own downloads; from there the cursor only moves forward.
+	auto block_size = static_cast<off_t>(m_cache_entry_size);
+	auto read_end_block =
+		(offset + static_cast<off_t>(size) - 1) / block_size * block_size +
+		block_size;
+	auto entries_end = std::max(m_a.m_off, m_b.m_off) + block_size;
+	m_prefetch_next =
+		std::max({m_prefetch_next, read_end_block, entries_end});
+
+	while (m_prefetches.size() < m_prefetch_window &&
+		   m_prefetch_next < file.content_length) {
+		auto entry = std::make_unique<PrefetchEntry>(*this);
+		entry->m_off = m_prefetch_next;
+		entry->m_cache_key = file.m_cache_key;
+		auto request_size =
+			std::min(static_cast<off_t>(m_cache_entry_size),
+					 file.content_length - m_prefetch_next);
+		entry->m_data.resize(request_size);
+		entry->m_request.reset(
+			new AmazonS3NonblockingDownload<PrefetchEntry>(
+				file.m_ai, file.m_object, file.m_log, entry->m_data.data(),
+				*entry));
+		if (!entry->m_request->SendRequest(entry->m_off, request_size)) {
+			file.m_log.Log(LogMask::Warning, "Prefetch",
+						   "Failed to issue readahead request:",
+						   entry->m_request->getErrorMessage().c_str());
+			break;
+		}
+		m_prefetch_count++;
+		m_prefetch_bytes += request_size;
+		m_prefetches.push_back(std::move(entry));
+		m_prefetch_next += block_size;
+	}
+}
+
+void S3File::S3Cache::DrainPrefetches() {
+	std::unique_lock lk(m_mutex);
+	m_cv.wait(lk, [&] {
+		for (const auto &entry : m_prefetches) {
+			if (!entry->m_done) {
+				return false;
+			}
+		}
+		return true;
+	});
+	m_prefetches.clear();
+}
+
 void S3File::S3Cache::Entry::Download(S3File &file) {
 	m_used = false;
-	m_data.resize(m_cache_entry_size);
+	m_cache_key = file.m_cache_key;
+
+	// The entry's slab comes from the process-wide pool, so steady-state
+	// reads recycle the same storage rather than re-allocating (and
+	// re-faulting) a multi-megabyte buffer per block.
+	static_assert(m_cache_entry_size == CacheSlabPool::m_slab_size,
+				  "cache entries must match the pooled slab size");
+	if (m_data.empty()) {
+		m_data = CacheSlabPool::Instance().Acquire();
+	}
+
+	// Before going to the network, see if another file handle has already
+	// published this block into the shared cache.  The caller holds the
+	// cache mutex, so the entry state can be updated directly; waiters are
+	// notified as if an in-progress download had completed.
+	auto block = S3BlockCache::Instance().Get(m_cache_key, m_off);
+	if (block) {
+		memcpy(m_data.data(), block->data(),
+			   std::min(block->size(), m_cache_entry_size));
+		m_failed = false;
+		m_inprogress = false;
+		m_parent.m_cv.notify_all();
+		return;
+	}
+
 	m_request.reset(new AmazonS3NonblockingDownload<Entry>(
 		file.m_ai, file.m_object, file.m_log, m_data.data(), *this));
 	size_t request_size = m_cache_entry_size;
@@ -1011,7 +1796,6 @@ XrdOss *XrdOssGetStorageSystem2(XrdOss *native_oss, XrdSysLogger *Logger,
 
 	envP->Export("XRDXROOTD_NOPOSC", "1");
 
-	S3File::LaunchMonitorThread();
 	try {
 		AmazonRequest::Init(*log);
 		g_s3_oss = new S3FileSystem(Logger, config_fn, envP);
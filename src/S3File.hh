@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "BufferPool.hh"
 #include "S3FileSystem.hh"
 
 #include <XrdOss/XrdOss.hh>
@@ -28,6 +29,9 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -44,7 +48,7 @@ class S3File : public XrdOssDF {
   public:
 	S3File(XrdSysError &log, S3FileSystem *oss);
 
-	virtual ~S3File() {}
+	virtual ~S3File();
 
 	int Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &env) override;
 
@@ -65,9 +69,7 @@ class S3File : public XrdOssDF {
 	int isCompressed(char *cxidp = 0) override { return -ENOSYS; }
 
 	ssize_t pgRead(void *buffer, off_t offset, size_t rdlen, uint32_t *csvec,
-				   uint64_t opts) override {
-		return -ENOSYS;
-	}
+				   uint64_t opts) override;
 
 	int pgRead(XrdSfsAio *aioparm, uint64_t opts) override { return -ENOSYS; }
 
@@ -82,13 +84,13 @@ class S3File : public XrdOssDF {
 
 	ssize_t Read(void *buffer, off_t offset, size_t size) override;
 
-	int Read(XrdSfsAio *aiop) override { return -ENOSYS; }
+	int Read(XrdSfsAio *aiop) override;
 
 	ssize_t ReadRaw(void *buffer, off_t offset, size_t size) override {
 		return -ENOSYS;
 	}
 
-	ssize_t ReadV(XrdOucIOVec *readV, int rdvcnt) override { return -ENOSYS; }
+	ssize_t ReadV(XrdOucIOVec *readV, int rdvcnt) override;
 
 	ssize_t Write(const void *buffer, off_t offset, size_t size) override;
 
@@ -101,21 +103,19 @@ class S3File : public XrdOssDF {
 	size_t getContentLength() { return content_length; }
 	time_t getLastModified() { return last_modified; }
 
-	// Launch the global monitor thread associated with S3File objects.
-	// Currently, the monitor thread is used to cleanup in-progress file
-	// transfers that have been abandoned.
-	static void LaunchMonitorThread();
-
   private:
-	// Periodic cleanup of in-progress transfers.
+	// Write a buffer at the current in-order write pointer, feeding the
+	// multipart upload pipeline (or the streaming variant when the final
+	// object size is unknown).  Must be invoked with the write lock held
+	// and `offset` equal to the write pointer.
+	ssize_t WriteInOrder(const void *buffer, off_t offset, size_t size);
+
+	// Feed buffered out-of-order segments whose turn has arrived into the
+	// upload pipeline, waking any writers blocked on a full reordering
+	// window.  Must be invoked with the write lock held.
 	//
-	// Iterates through the global list of pending multipart uploads
-	// that may be paused.  For each, call `Tick` on the upload and
-	// see if the transfer has aborted.
-	static void CleanupTransfers();
-
-	// Single cleanup run for in-progress transfers.
-	static void CleanupTransfersOnce();
+	// Returns 0 on success or a negative errno value on failure.
+	ssize_t DrainReorderWindow();
 
 	// Write data while in "streaming mode" where we don't know the
 	// ultimate size of the file (and hence can't start streaming
@@ -128,9 +128,48 @@ class S3File : public XrdOssDF {
 
 	ssize_t ContinueSendPart(const void *buffer, size_t size);
 
+	// Collect the response for the oldest part upload in the write pipeline,
+	// recording its ETag (ETags must be presented to the completion request
+	// in part order).
+	//
+	// Returns 0 on success or a negative errno value on failure.
+	ssize_t HarvestOldestPart();
+
+	// Wait for every part upload still in the write pipeline to complete,
+	// harvesting the ETags as they arrive.
+	//
+	// Returns 0 on success or a negative errno value on failure.
+	ssize_t DrainPartPipeline();
+
+	// Synchronization helper for `ReadV` and striped bypass reads; counts
+	// down as each of the concurrent ranged GETs completes.
+	struct VectorReadTracker {
+		std::mutex m_mutex; // Mutex protecting m_outstanding.
+		std::condition_variable m_cv;
+		int m_outstanding{0}; // Count of ranged GETs not yet completed.
+
+		void Notify(); // Invoked by each download as it completes.
+		void Wait();   // Block until all outstanding downloads complete.
+	};
+
+	// A contiguous byte range covering one or more coalesced fragments of
+	// a vector read.
+	struct VectorReadRange {
+		off_t m_off{0};	  // File offset of the beginning of the range.
+		size_t m_size{0}; // Size of the coalesced range.
+		std::vector<int> m_fragments; // Indices of the fragments served.
+		std::vector<char> m_buffer;	  // Download buffer for the range.
+		std::unique_ptr<AmazonS3NonblockingDownload<VectorReadTracker>>
+			m_request; // In-progress request to fill the range.
+	};
+
 	// Download data synchronously, bypassing the cache.
 	// The download is only performed if the request size is larger than a cache
-	// entry.
+	// entry.  Requests spanning several multiples of `m_bypass_stripe_size`
+	// are split into concurrent sub-range GETs (bounded by the configured
+	// `s3.bypass_streams`), each writing directly into its slice of the
+	// caller's buffer, so a large read aggregates the bandwidth of several
+	// connections.
 	//
 	// - `offset`: File offset of the request.
 	// - `size`: Size of the request.
@@ -144,31 +183,68 @@ class S3File : public XrdOssDF {
 	S3FileSystem *m_oss;
 
 	std::string m_object;
+	// Export prefix the file was opened under; identifies the upload in
+	// the persistent upload journal.
+	std::string m_exposed_path;
+	// Key identifying this object (endpoint, bucket, object) in the
+	// process-wide shared block cache.
+	std::string m_cache_key;
 	S3AccessInfo m_ai;
 
 	off_t content_length;
 	time_t last_modified;
 
-	static const size_t m_s3_part_size =
-		100'000'000; // The size of each S3 chunk.
+	// Upper bound on the number of parts a multipart upload should produce;
+	// the part size is scaled up at open time so very large objects do not
+	// pay per-part signing and ETag bookkeeping for tens of thousands of
+	// parts (and the completion XML stays small).
+	static constexpr size_t m_max_part_count = 1000;
+
+	// Number of parts sent between each doubling of the part size when the
+	// object size is unknown (streaming writes).
+	static constexpr size_t m_part_growth_interval = 64;
 
 	static constexpr size_t m_cache_entry_size =
 		(2 * 1024 * 1024); // Size of the buffer associated with the cache
 
+	static constexpr size_t m_readv_gap_size =
+		(256 * 1024); // Maximum gap between two vector-read fragments that
+					  // will be coalesced into a single ranged GET.
+
+	static constexpr size_t m_readv_max_range_size =
+		(16 * 1024 * 1024); // Maximum size of a coalesced vector-read GET.
+
+	static constexpr size_t m_bypass_stripe_size =
+		(64 * 1024 * 1024); // Bytes of a cache-bypass read per concurrent
+							// sub-range GET; a request this large or
+							// smaller stays a single stream.
+
 	bool m_create{false};
 	int partNumber;
 	size_t m_part_written{
 		0}; // Number of bytes written for the current upload chunk.
 	size_t m_part_size{0};	 // Size of the current upload chunk (0 if unknon);
+	size_t m_upload_part_size{
+		0}; // Size of each part for this handle's multipart upload; chosen at
+			// open time from the expected object size (oss.asize) and grown
+			// geometrically during streaming writes of unknown length.
 	off_t m_write_offset{0}; // Offset of the file pointer for writes (helps
 							 // detect out-of-order writes).
 	off_t m_object_size{
 		-1}; // Expected size of the completed object; -1 if unknown.
 	std::string uploadId; // For creates, upload ID as assigned by t
 	std::vector<std::string> eTags;
+	// Per-part CRC32C checksums (base64), harvested alongside the ETags;
+	// entries are empty for parts uploaded without a checksum.
+	std::vector<std::string> m_part_checksums;
+	// Bytes covered by the parts whose ETags have been harvested; the
+	// offset an interrupted upload can later be resumed from.
+	off_t m_journal_committed{0};
 	// When using the "streaming mode", the upload part has to be completely
-	// buffered within the S3File object; this is the current buffer.
-	std::string m_streaming_buffer;
+	// buffered within the S3File object; this is the current buffer.  It
+	// is composed of fixed-size pooled segments so buffering a 100MB part
+	// causes neither reallocation copies nor allocator churn.
+	SegmentedBuffer m_streaming_buffer;
 
 	// The mutex protecting write activities.  Writes must currently be
 	// serialized as we aggregate them into large operations and upload them to
@@ -184,23 +260,47 @@ class S3File : public XrdOssDF {
 	std::shared_ptr<AmazonS3SendMultipartPart>
 		m_write_op; // The in-progress operation for a multi-part upload.
 
-	// The multipart uploads represent an in-progress request and the global
-	// cleanup thread may decide to trigger a failure if the request does not
-	// advance after some time period.
-	//
-	// To do so, we must be able to lock the associated write mutex and then
-	// call `Tick` on the upload.  To avoid prolonging the lifetime of the
-	// objects beyond the S3File, we hold onto a reference via a weak pointer.
-	// Mutable operations on this vector are protected by the `m_pending_lk`.
-	static std::vector<std::pair<std::weak_ptr<std::mutex>,
-								 std::weak_ptr<AmazonS3SendMultipartPart>>>
-		m_pending_ops;
+	// A part upload whose payload has been handed off to the curl workers but
+	// whose response (and hence ETag) has not yet been collected.
+	struct InflightPart {
+		std::shared_ptr<AmazonS3SendMultipartPart> m_op;
+		// Owns the part's final payload bytes until the upload completes;
+		// the curl workers reference this buffer asynchronously.
+		std::string m_buffer;
+		// For parts buffered in streaming mode, the pooled segments holding
+		// the part's payload.
+		SegmentedBuffer m_segments;
+		// Total payload size of the part; advances the journaled committed
+		// offset once the part's ETag is harvested.
+		size_t m_size{0};
+	};
+
+	// Part uploads currently in flight, oldest first.  Writes only block
+	// once the pipeline is full; the ETags are harvested in part order.
+	// Protected by the m_write_lk mutex.
+	std::deque<InflightPart> m_inflight_parts;
+
+	// Maximum number of part uploads kept in flight concurrently; copied
+	// from the filesystem configuration at open time.
+	size_t m_pipeline_depth{1};
+
+	// Number of part-sizes worth of out-of-order data buffered before
+	// writers ahead of the stream are blocked for backpressure.
+	static constexpr size_t m_reorder_window_parts = 4;
+
+	// Out-of-order segments buffered until the writes before them arrive;
+	// parallel client streams (e.g., `xrdcp --streams`) deliver interleaved
+	// offsets that S3 cannot accept directly.  Keyed by file offset and
+	// composed of pooled segments.  Protected by the m_write_lk mutex.
+	std::map<off_t, SegmentedBuffer> m_reorder_buffers;
 
-	// Mutex protecting the m_pending_ops variable.
-	static std::mutex m_pending_lk;
+	// Total bytes currently held in m_reorder_buffers.
+	size_t m_reorder_bytes{0};
 
-	// Flag determining whether the monitoring thread has been launched.
-	static std::once_flag m_monitor_launch;
+	// Notified whenever the in-order write pointer advances (or the upload
+	// fails); writers whose data does not fit in the reordering window
+	// block here.
+	std::condition_variable m_reorder_cv;
 
 	// The double-buffering component for the file handle.  Reads are rounded up
 	// to a particular size and kept in the file handle; before requesting new
@@ -216,7 +316,11 @@ class S3File : public XrdOssDF {
 							 // -1 signifies unused entry
 			size_t m_used{
 				0}; // The number of bytes read out of the current cache entry.
-			std::vector<char> m_data; // Contents of cache entry
+			CacheSlabPool::Slab
+				m_data; // Pooled slab holding the entry contents; borrowed
+						// for the lifetime of the filled block.
+			std::string m_cache_key;  // Shared block cache key for the object
+									  // being downloaded.
 			S3Cache &m_parent;		  // Reference to owning object
 			std::unique_ptr<AmazonS3NonblockingDownload<Entry>>
 				m_request; // In-progress request to fill entry.
@@ -240,6 +344,42 @@ class S3File : public XrdOssDF {
 			std::tuple<off_t, size_t, off_t, size_t>
 			OverlapCopy(off_t req_off, size_t req_size, char *req_buf);
 		};
+		// An in-flight readahead block being downloaded ahead of a detected
+		// sequential stream.  Unlike the two main cache entries, prefetched
+		// blocks are published to the process-wide S3BlockCache, where a
+		// subsequent Entry::Download for the same offset will find them.
+		struct PrefetchEntry {
+			off_t m_off{-1};		  // Aligned file offset of the block.
+			std::vector<char> m_data; // Download buffer for the block.
+			std::string m_cache_key;  // Shared block cache key for the object.
+			S3Cache &m_parent;		  // Reference to owning cache object.
+			bool m_done{false};		  // Set once the download has completed.
+			std::unique_ptr<AmazonS3NonblockingDownload<PrefetchEntry>>
+				m_request; // In-progress request to fill the block.
+
+			PrefetchEntry(S3Cache &cache) : m_parent(cache) {}
+			void Notify(); // Notify the owning cache that the download has
+						   // completed.
+		};
+
+		// An asynchronous read posted through the XrdSfsAio interface.  The
+		// request is clamped and split on cache-entry boundaries at submit
+		// time, so at most two sub-ranges remain; each is erased (offset set
+		// to -1) as the corresponding cache entry fills.  The completion
+		// callback fires once both are gone.
+		struct AioRead {
+			XrdSfsAio *m_aiop{nullptr}; // The client's aio control block.
+			S3File *m_file{
+				nullptr};	   // The file handle that posted the request.
+			char *m_buffer;	   // The client's destination buffer.
+			off_t m_base_off;  // File offset of the beginning of the buffer.
+			size_t m_total{0}; // Clamped size of the overall request.
+			off_t m_off{-1};   // Offset of the first remaining sub-range.
+			size_t m_size{0};  // Size of the first remaining sub-range.
+			off_t m_off2{-1};  // Offset of the second remaining sub-range.
+			size_t m_size2{0}; // Size of the second remaining sub-range.
+		};
+
 		friend class AmazonS3NonblockingDownload<S3File::S3Cache::Entry>;
 
 		std::atomic<off_t> m_hit_bytes{0}; // Bytes served from the cache.
@@ -291,6 +431,73 @@ class S3File : public XrdOssDF {
 
 		// Trigger a blocking read from a given file
 		ssize_t Read(S3File &file, char *buffer, off_t offset, size_t size);
+
+		// Post an asynchronous read.  If the request can be served from the
+		// cache entries immediately, the aio completion fires before this
+		// returns; otherwise the request is queued and completed from the
+		// download notification chain without parking a thread.
+		//
+		// Always returns 0; errors are reported through the aio result.
+		int ReadAio(S3File &file, XrdSfsAio *aiop);
+
+		// Advance every queued asynchronous read as far as the current cache
+		// entry contents allow, scheduling downloads for still-missing
+		// blocks.  Requests that finished (or failed) are appended to
+		// `completed` along with their result; the caller must invoke the
+		// aio callbacks after dropping the cache mutex, as a callback may
+		// re-enter with a follow-up read.  Must be called with m_mutex held.
+		void ProgressAioReads(
+			std::vector<std::pair<XrdSfsAio *, ssize_t>> &completed);
+
+		// Copy any data the idle cache entries hold into the given request,
+		// erasing satisfied sub-ranges.  Returns 1 if the request is now
+		// complete, -1 if a failed download was consumed on its behalf, and
+		// 0 if data is still missing.  Must be called with m_mutex held.
+		int TryServeAio(AioRead &aio);
+
+		// Point idle cache entries at the blocks a queued request still
+		// needs and start their downloads.  Returns true if any download
+		// completed inline (e.g., served from the shared block cache),
+		// meaning another serve pass may make progress.  Must be called
+		// with m_mutex held.
+		bool ScheduleAioDownloads(AioRead &aio);
+
+		// Block until every queued asynchronous read has completed and the
+		// cache entries are idle; must be invoked before the cache object is
+		// destroyed as the downloads reference the entry buffers.
+		void DrainAioReads();
+
+		// Advance the sequential-stream detector with the current read and
+		// issue any readahead blocks the resulting window allows.
+		void Prefetch(S3File &file, off_t offset, size_t size);
+
+		// Block until all in-flight readahead downloads have completed;
+		// must be invoked before the cache object is destroyed.
+		void DrainPrefetches();
+
+		// Initial readahead depth, in blocks, once a sequential stream is
+		// detected; the window doubles per sequential read up to the
+		// configured maximum.
+		static constexpr size_t m_min_window = 2;
+
+		// State of the sequential-stream detector driving readahead.  All
+		// of the following are protected by m_mutex.
+		off_t m_next_seq_off{
+			-1}; // Expected offset of the next sequential read.
+		size_t m_seq_streak{0};		 // Count of consecutive sequential reads.
+		size_t m_prefetch_window{0}; // Current readahead depth, in blocks.
+		off_t m_prefetch_next{-1};	 // Next block offset to be prefetched.
+		std::list<std::unique_ptr<PrefetchEntry>>
+			m_prefetches; // In-flight readahead blocks.
+
+		// Asynchronous reads waiting on cache-entry downloads, oldest first.
+		// Protected by m_mutex.
+		std::list<std::unique_ptr<AioRead>> m_aio_reads;
 	};
 	S3Cache m_cache;
+
+	// Maximum readahead depth, in blocks, for sequential streams; copied
+	// from the filesystem configuration at open time.  Zero disables the
+	// readahead entirely.
+	size_t m_prefetch_max_blocks{0};
 };
@@ -17,9 +17,16 @@
  ***************************************************************/
 
 #include "S3FileSystem.hh"
+#include "BufferPool.hh"
+#include "CurlWorker.hh"
 #include "S3AccessInfo.hh"
+#include "S3BlockCache.hh"
 #include "S3Directory.hh"
 #include "S3File.hh"
+#include "S3ListingCache.hh"
+#include "S3StatCache.hh"
+#include "TransferStats.hh"
+#include "UploadJournal.hh"
 #include "logging.hh"
 #include "shortfile.hh"
 #include "stl_string_utils.hh"
@@ -30,10 +37,14 @@
 #include <XrdVersion.hh>
 
 #include <algorithm>
+#include <charconv>
+#include <deque>
 #include <filesystem>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #include <fcntl.h>
@@ -81,6 +92,12 @@ bool S3FileSystem::Config(XrdSysLogger *lp, const char *configfn) {
 	std::string attribute;
 	std::shared_ptr<S3AccessInfo> newAccessInfo(new S3AccessInfo());
 	std::string exposedPath;
+	size_t statsInterval{0};
+	std::string statsFile;
+	std::string diskCacheDir;
+	size_t diskCacheSize{0};
+	std::string uploadJournalDir;
+	size_t uploadReapAge{0};
 	m_log.setMsgMask(0);
 	while ((temporary = s3server_conf.GetLine())) {
 		attribute = s3server_conf.GetToken();
@@ -173,6 +190,214 @@ bool S3FileSystem::Config(XrdSysLogger *lp, const char *configfn) {
 		else if (attribute == "s3.url_style") {
 			s3_url_style = value;
 			newAccessInfo->setS3UrlStyle(s3_url_style);
+		} else if (attribute == "s3.cache_size") {
+			size_t cacheSize{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), cacheSize);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.cache_size must be a byte count:", value.c_str());
+				return false;
+			}
+			S3BlockCache::SetCacheSize(cacheSize);
+			// The slab pool backing the per-file cache entries shares the
+			// same memory budget.
+			CacheSlabPool::SetMaxFreeBytes(cacheSize);
+		} else if (attribute == "s3.disk_cache_dir") {
+			diskCacheDir = value;
+		} else if (attribute == "s3.disk_cache_size") {
+			size_t bytes{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), bytes);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				bytes == 0) {
+				m_log.Emsg("Config",
+						   "s3.disk_cache_size must be a positive byte count:",
+						   value.c_str());
+				return false;
+			}
+			diskCacheSize = bytes;
+		} else if (attribute == "s3.upload_journal_dir") {
+			uploadJournalDir = value;
+		} else if (attribute == "s3.upload_reap_age") {
+			size_t age{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), age);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				age == 0) {
+				m_log.Emsg("Config",
+						   "s3.upload_reap_age must be a time in seconds:",
+						   value.c_str());
+				return false;
+			}
+			uploadReapAge = age;
+		} else if (attribute == "s3.part_pipeline_depth") {
+			size_t depth{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), depth);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				depth == 0) {
+				m_log.Emsg("Config",
+						   "s3.part_pipeline_depth must be a positive integer:",
+						   value.c_str());
+				return false;
+			}
+			m_part_pipeline_depth = depth;
+		} else if (attribute == "s3.part_size_min") {
+			size_t bytes{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), bytes);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				bytes == 0) {
+				m_log.Emsg("Config", "s3.part_size_min must be a byte count:",
+						   value.c_str());
+				return false;
+			}
+			m_part_size_min = bytes;
+		} else if (attribute == "s3.part_size_max") {
+			size_t bytes{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), bytes);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				bytes == 0) {
+				m_log.Emsg("Config", "s3.part_size_max must be a byte count:",
+						   value.c_str());
+				return false;
+			}
+			m_part_size_max = bytes;
+		} else if (attribute == "s3.prefetch_blocks") {
+			size_t blocks{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), blocks);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.prefetch_blocks must be a block count:",
+						   value.c_str());
+				return false;
+			}
+			m_prefetch_blocks = blocks;
+		} else if (attribute == "s3.stats_interval") {
+			size_t interval{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), interval);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.stats_interval must be a time in seconds:",
+						   value.c_str());
+				return false;
+			}
+			statsInterval = interval;
+		} else if (attribute == "s3.slow_request_threshold") {
+			size_t threshold{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), threshold);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.slow_request_threshold must be a time in "
+						   "milliseconds:",
+						   value.c_str());
+				return false;
+			}
+			HTTPRequest::SetSlowRequestThreshold(
+				std::chrono::milliseconds(threshold));
+		} else if (attribute == "s3.stats_file") {
+			statsFile = value;
+		} else if (attribute == "s3.stat_cache_ttl") {
+			size_t ttl{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), ttl);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.stat_cache_ttl must be a time in seconds:",
+						   value.c_str());
+				return false;
+			}
+			S3StatCache::SetTTL(std::chrono::seconds(ttl));
+		} else if (attribute == "s3.stat_cache_entries") {
+			size_t entries{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), entries);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				entries == 0) {
+				m_log.Emsg("Config",
+						   "s3.stat_cache_entries must be a positive integer:",
+						   value.c_str());
+				return false;
+			}
+			S3StatCache::SetCapacity(entries);
+		} else if (attribute == "s3.listing_cache_ttl") {
+			size_t ttl{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), ttl);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg("Config",
+						   "s3.listing_cache_ttl must be a time in seconds:",
+						   value.c_str());
+				return false;
+			}
+			S3ListingCache::SetTTL(std::chrono::seconds(ttl));
+		} else if (attribute == "s3.listing_cache_size") {
+			size_t bytes{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), bytes);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				bytes == 0) {
+				m_log.Emsg("Config",
+						   "s3.listing_cache_size must be a positive byte "
+						   "count:",
+						   value.c_str());
+				return false;
+			}
+			S3ListingCache::SetCacheSize(bytes);
+		} else if (attribute == "s3.worker_threads") {
+			unsigned threads{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), threads);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				threads == 0) {
+				m_log.Emsg("Config",
+						   "s3.worker_threads must be a positive integer:",
+						   value.c_str());
+				return false;
+			}
+			CurlWorker::SetPollThreads(threads);
+		} else if (attribute == "s3.bypass_streams") {
+			size_t streams{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), streams);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				streams == 0) {
+				m_log.Emsg("Config",
+						   "s3.bypass_streams must be a positive integer:",
+						   value.c_str());
+				return false;
+			}
+			m_bypass_streams = streams;
+		} else if (attribute == "s3.prewarm_connections") {
+			size_t conns{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), conns);
+			if (ec != std::errc() || ptr != value.c_str() + value.size()) {
+				m_log.Emsg(
+					"Config",
+					"s3.prewarm_connections must be a non-negative integer:",
+					value.c_str());
+				return false;
+			}
+			m_prewarm_connections = conns;
+		} else if (attribute == "s3.max_concurrent_streams") {
+			long streams{0};
+			auto [ptr, ec] = std::from_chars(
+				value.c_str(), value.c_str() + value.size(), streams);
+			if (ec != std::errc() || ptr != value.c_str() + value.size() ||
+				streams <= 0) {
+				m_log.Emsg(
+					"Config",
+					"s3.max_concurrent_streams must be a positive integer:",
+					value.c_str());
+				return false;
+			}
+			CurlWorker::SetMaxConcurrentStreams(streams);
 		}
 	}
 
@@ -190,6 +415,65 @@ bool S3FileSystem::Config(XrdSysLogger *lp, const char *configfn) {
 		return false;
 	}
 
+	if (!diskCacheDir.empty()) {
+		if (!diskCacheSize) {
+			m_log.Emsg("Config", "s3.disk_cache_size must be set when "
+								 "s3.disk_cache_dir is configured");
+			return false;
+		}
+		std::error_code ec;
+		std::filesystem::create_directories(diskCacheDir, ec);
+		if (ec) {
+			m_log.Emsg("Config", "Failed to create the disk cache directory:",
+					   diskCacheDir.c_str());
+			return false;
+		}
+		S3BlockCache::SetDiskCache(diskCacheDir, diskCacheSize);
+	}
+
+	if (!uploadJournalDir.empty()) {
+		std::error_code ec;
+		std::filesystem::create_directories(uploadJournalDir, ec);
+		if (ec) {
+			m_log.Emsg("Config",
+					   "Failed to create the upload journal directory:",
+					   uploadJournalDir.c_str());
+			return false;
+		}
+		UploadJournal::SetJournalDir(uploadJournalDir);
+		if (uploadReapAge) {
+			std::thread t(&S3FileSystem::UploadReaperLoop, this,
+						  std::chrono::seconds(uploadReapAge));
+			t.detach();
+		}
+	}
+
+	if (statsInterval) {
+		// Have the statistics dump include the shared block cache's counters
+		// alongside the per-handle cache totals.
+		TransferStats::Instance().AddStatsSource("shared_cache", [] {
+			auto &cache = S3BlockCache::Instance();
+			std::ostringstream ss;
+			ss << "{\"hit_count\":" << cache.m_shared_hit_count.load()
+			   << ",\"miss_count\":" << cache.m_shared_miss_count.load()
+			   << ",\"eviction_count\":" << cache.m_eviction_count.load()
+			   << ",\"disk_hit_count\":" << cache.m_disk_hit_count.load()
+			   << ",\"disk_spill_count\":" << cache.m_disk_spill_count.load()
+			   << ",\"cache_size\":" << S3BlockCache::GetCacheSize() << "}";
+			return ss.str();
+		});
+		TransferStats::Instance().LaunchStatsThread(
+			m_log, std::chrono::seconds(statsInterval), statsFile);
+	}
+
+	buildExportIndex();
+
+	if (m_prewarm_connections && !m_s3_access_map.empty()) {
+		std::thread t(&S3FileSystem::PrewarmEndpoints, this,
+					  m_prewarm_connections);
+		t.detach();
+	}
+
 	return true;
 }
 
@@ -271,78 +555,236 @@ int S3FileSystem::Stat(const char *path, struct stat *buff, int opts,
 
 	// First, check to see if the file name is an object.  If it's
 	// a 404 response, then we will assume it may be a directory.
-	AmazonS3Head headCommand = AmazonS3Head(*ai, object, m_log);
-	auto res = headCommand.SendRequest();
-	if (res) {
-		if (buff) {
-			memset(buff, '\0', sizeof(struct stat));
-			if (object == m_dir_marker_name) {
+	// The metadata cache is consulted first; the redirector typically
+	// stats the path immediately before the client's open does the
+	// same HEAD, so only the first of the pair goes to the endpoint.
+	const auto statKey =
+		ai->getS3ServiceUrl() + "/" + ai->getS3BucketName() + "/" + object;
+	const auto dirKey = statKey + "/";
+	S3StatCache::ObjectInfo info;
+	bool cachedNegative = false;
+	// A speculative listing of the prefix, launched alongside the HEAD so
+	// a directory stat costs one round trip instead of two serialized ones.
+	std::unique_ptr<AmazonS3List> probeCommand;
+	if (S3StatCache::Instance().Get(statKey, info)) {
+		if (info.m_response_code == 404) {
+			cachedNegative = true;
+		} else {
+			if (buff) {
+				memset(buff, '\0', sizeof(struct stat));
+				if (object == m_dir_marker_name) {
+					buff->st_mode = 0700 | S_IFDIR;
+					buff->st_size = 4096;
+					buff->st_nlink = 0;
+				} else {
+					buff->st_mode = 0600 | S_IFREG;
+					buff->st_size = info.m_size;
+					buff->st_nlink = 1;
+				}
+				buff->st_uid = buff->st_gid = 1;
+				buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+				buff->st_dev = 0;
+				buff->st_ino = 1;
+			}
+			return 0;
+		}
+	}
+	if (cachedNegative) {
+		// A cached 404; mirror the handling of a fresh 404 below.
+		if (object == m_dir_marker_name) {
+			if (buff) {
+				memset(buff, '\0', sizeof(struct stat));
 				buff->st_mode = 0700 | S_IFDIR;
-				buff->st_size = 4096;
 				buff->st_nlink = 0;
-			} else {
-				buff->st_mode = 0600 | S_IFREG;
-				buff->st_size = headCommand.getSize();
-				buff->st_nlink = 1;
+				buff->st_uid = 1;
+				buff->st_gid = 1;
+				buff->st_size = 4096;
+				buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+				buff->st_dev = 0;
+				buff->st_ino = 1;
 			}
-			buff->st_uid = buff->st_gid = 1;
-			buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
-			buff->st_dev = 0;
-			buff->st_ino = 1;
+			return 0;
 		}
-		return 0;
+		object = object + "/";
 	} else {
-		auto httpCode = headCommand.getResponseCode();
-		if (httpCode == 0) {
-			if (m_log.getMsgMask() & XrdHTTPServer::Info) {
-				std::stringstream ss;
-				ss << "Failed to stat path " << path
-				   << "; error: " << headCommand.getErrorMessage()
-				   << " (code=" << headCommand.getErrorCode() << ")";
-				m_log.Log(XrdHTTPServer::Info, "Stat", ss.str().c_str());
+		AmazonS3Head headCommand = AmazonS3Head(*ai, object, m_log);
+		auto res = headCommand.SendRequest(false);
+		// While the HEAD is in flight, launch the pseudo-directory probe
+		// on the worker pool; if the HEAD comes back 404 we would
+		// otherwise pay a second serialized round trip for the listing.
+		// Skip the speculation when a cached answer for the prefix exists
+		// or the name is the directory marker (a 404 already resolves it).
+		if (res && object != m_dir_marker_name) {
+			S3StatCache::ObjectInfo dirInfo;
+			if (!S3StatCache::Instance().Get(dirKey, dirInfo) &&
+				!S3ListingCache::Instance().Get(dirKey)) {
+				probeCommand.reset(
+					new AmazonS3List(*ai, object + "/", 1, m_log));
+				if (!probeCommand->SendRequest("", false)) {
+					// Fall back to a blocking listing if it's needed.
+					probeCommand.reset();
+				}
 			}
-			return -EIO;
 		}
-		if (httpCode == 404) {
-			if (object == m_dir_marker_name) {
-				if (buff) {
-					memset(buff, '\0', sizeof(struct stat));
+		if (res) {
+			res = headCommand.WaitForCompletion();
+		}
+		if (res) {
+			// The object exists; collect the speculative listing (the curl
+			// workers still reference it) and discard its answer.
+			if (probeCommand) {
+				probeCommand->WaitForCompletion();
+				probeCommand.reset();
+			}
+			info.m_size = headCommand.getSize();
+			info.m_last_modified = headCommand.getLastModified();
+			S3StatCache::Instance().Put(statKey, info);
+			if (buff) {
+				memset(buff, '\0', sizeof(struct stat));
+				if (object == m_dir_marker_name) {
 					buff->st_mode = 0700 | S_IFDIR;
-					buff->st_nlink = 0;
-					buff->st_uid = 1;
-					buff->st_gid = 1;
 					buff->st_size = 4096;
-					buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
-					buff->st_dev = 0;
-					buff->st_ino = 1;
+					buff->st_nlink = 0;
+				} else {
+					buff->st_mode = 0600 | S_IFREG;
+					buff->st_size = headCommand.getSize();
+					buff->st_nlink = 1;
 				}
-				return 0;
+				buff->st_uid = buff->st_gid = 1;
+				buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+				buff->st_dev = 0;
+				buff->st_ino = 1;
 			}
-			object = object + "/";
+			return 0;
 		} else {
-			if (m_log.getMsgMask() & XrdHTTPServer::Info) {
-				std::stringstream ss;
-				ss << "Failed to stat path " << path << "; response code "
-				   << httpCode;
-				m_log.Log(XrdHTTPServer::Info, "Stat", ss.str().c_str());
+			auto httpCode = headCommand.getResponseCode();
+			if (httpCode == 0) {
+				if (m_log.getMsgMask() & XrdHTTPServer::Info) {
+					std::stringstream ss;
+					ss << "Failed to stat path " << path
+					   << "; error: " << headCommand.getErrorMessage()
+					   << " (code=" << headCommand.getErrorCode() << ")";
+					m_log.Log(XrdHTTPServer::Info, "Stat", ss.str().c_str());
+				}
+				if (probeCommand) {
+					probeCommand->WaitForCompletion();
+				}
+				return -EIO;
+			}
+			if (httpCode == 404) {
+				info.m_response_code = 404;
+				S3StatCache::Instance().Put(statKey, info);
+				if (object == m_dir_marker_name) {
+					if (buff) {
+						memset(buff, '\0', sizeof(struct stat));
+						buff->st_mode = 0700 | S_IFDIR;
+						buff->st_nlink = 0;
+						buff->st_uid = 1;
+						buff->st_gid = 1;
+						buff->st_size = 4096;
+						buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+						buff->st_dev = 0;
+						buff->st_ino = 1;
+					}
+					return 0;
+				}
+				object = object + "/";
+			} else {
+				if (m_log.getMsgMask() & XrdHTTPServer::Info) {
+					std::stringstream ss;
+					ss << "Failed to stat path " << path << "; response code "
+					   << httpCode;
+					m_log.Log(XrdHTTPServer::Info, "Stat", ss.str().c_str());
+				}
+				if (probeCommand) {
+					probeCommand->WaitForCompletion();
+				}
+				return httpCode == 403 ? -EACCES : -EIO;
 			}
-			return httpCode == 403 ? -EACCES : -EIO;
 		}
 	}
 
+	// The object does not exist; before issuing a listing to see whether
+	// the name is a pseudo-directory, check for a cached answer for the
+	// prefix (stored under the object name with the trailing slash).
+	// When the speculative probe is already in flight, the caches were
+	// checked just before it was launched -- skip straight to collecting
+	// the response.
+	if (!probeCommand && S3StatCache::Instance().Get(dirKey, info)) {
+		if (info.m_response_code == 404) {
+			return -ENOENT;
+		}
+		if (buff) {
+			memset(buff, '\0', sizeof(struct stat));
+			buff->st_mode = 0700 | S_IFDIR;
+			buff->st_nlink = 0;
+			buff->st_uid = 1;
+			buff->st_gid = 1;
+			buff->st_size = 4096;
+			buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+			buff->st_dev = 0;
+			buff->st_ino = 1;
+		}
+		return 0;
+	}
+	info = S3StatCache::ObjectInfo();
+
+	// A completed listing of the prefix may already be cached (the listing
+	// cache keys prefixes the same way as dirKey); answer the directory
+	// probe from it without a round trip.
+	if (auto listing = probeCommand ? nullptr
+									: S3ListingCache::Instance().Get(dirKey)) {
+		bool foundObj = false;
+		for (const auto &obj : listing->m_objects) {
+			if (obj.m_key == object) {
+				foundObj = true;
+				break;
+			}
+		}
+		if (foundObj || (listing->m_objects.empty() &&
+						 listing->m_common_prefixes.empty())) {
+			info.m_response_code = 404;
+			S3StatCache::Instance().Put(dirKey, info);
+			return -ENOENT;
+		}
+		info.m_is_directory = true;
+		S3StatCache::Instance().Put(dirKey, info);
+		if (buff) {
+			memset(buff, '\0', sizeof(struct stat));
+			buff->st_mode = 0700 | S_IFDIR;
+			buff->st_nlink = 0;
+			buff->st_uid = 1;
+			buff->st_gid = 1;
+			buff->st_size = 4096;
+			buff->st_mtime = buff->st_atime = buff->st_ctime = 0;
+			buff->st_dev = 0;
+			buff->st_ino = 1;
+		}
+		return 0;
+	}
+
 	// List the object name as a pseudo-directory.  Limit the results
 	// back to a single item (we're just looking to see if there's a
 	// common prefix here).
-	AmazonS3List listCommand(*ai, object, 1, m_log);
-	res = listCommand.SendRequest("");
+	std::unique_ptr<AmazonS3List> listCommand;
+	bool res;
+	if (probeCommand) {
+		// The listing was issued while the HEAD was in flight; collect
+		// its response.
+		listCommand = std::move(probeCommand);
+		res = listCommand->WaitForCompletion();
+	} else {
+		listCommand.reset(new AmazonS3List(*ai, object, 1, m_log));
+		res = listCommand->SendRequest("");
+	}
 	if (!res) {
-		auto httpCode = listCommand.getResponseCode();
+		auto httpCode = listCommand->getResponseCode();
 		if (httpCode == 0) {
 			if (m_log.getMsgMask() & XrdHTTPServer::Info) {
 				std::stringstream ss;
 				ss << "Failed to stat path " << path
-				   << "; error: " << listCommand.getErrorMessage()
-				   << " (code=" << listCommand.getErrorCode() << ")";
+				   << "; error: " << listCommand->getErrorMessage()
+				   << " (code=" << listCommand->getErrorCode() << ")";
 				m_log.Log(XrdHTTPServer::Info, "Stat", ss.str().c_str());
 			}
 			return -EIO;
@@ -368,7 +810,7 @@ int S3FileSystem::Stat(const char *path, struct stat *buff, int opts,
 	std::vector<S3ObjectInfo> objInfo;
 	std::vector<std::string> commonPrefixes;
 	std::string ct;
-	res = listCommand.Results(objInfo, commonPrefixes, ct, errMsg);
+	res = listCommand->Results(objInfo, commonPrefixes, ct, errMsg);
 	if (!res) {
 		m_log.Log(XrdHTTPServer::Warning, "Stat",
 				  "Failed to parse S3 results:", errMsg.c_str());
@@ -394,13 +836,20 @@ int S3FileSystem::Stat(const char *path, struct stat *buff, int opts,
 		}
 	}
 	if (foundObj) {
+		info.m_response_code = 404;
+		S3StatCache::Instance().Put(dirKey, info);
 		return -ENOENT;
 	}
 
 	if (!objInfo.size() && !commonPrefixes.size()) {
+		info.m_response_code = 404;
+		S3StatCache::Instance().Put(dirKey, info);
 		return -ENOENT;
 	}
 
+	info.m_is_directory = true;
+	S3StatCache::Instance().Put(dirKey, info);
+
 	if (buff) {
 		memset(buff, '\0', sizeof(struct stat));
 		buff->st_mode = 0700 | S_IFDIR;
@@ -415,6 +864,421 @@ int S3FileSystem::Stat(const char *path, struct stat *buff, int opts,
 	return 0;
 }
 
+int S3FileSystem::Unlink(const char *path, int Opts, XrdOucEnv *env) {
+	m_log.Log(XrdHTTPServer::Debug, "Unlink", "Unlinking path", path);
+
+	std::string exposedPath, object;
+	auto rv = parsePath(path, exposedPath, object);
+	if (rv != 0) {
+		return rv;
+	}
+	auto ai = getS3AccessInfo(exposedPath, object);
+	if (!ai) {
+		return -ENOENT;
+	}
+	if (ai->getS3BucketName().empty()) {
+		return -EINVAL;
+	}
+
+	trimslashes(object);
+	if (object.empty()) {
+		// Refuse to remove the contents of the entire bucket.
+		return -EISDIR;
+	}
+
+	const auto statKey =
+		ai->getS3ServiceUrl() + "/" + ai->getS3BucketName() + "/" + object;
+
+	// Determine whether the name refers to an object or a pseudo-directory.
+	AmazonS3Head headCommand(*ai, object, m_log);
+	if (headCommand.SendRequest()) {
+		AmazonS3DeleteObjects deleteCommand(*ai, m_log);
+		if (!deleteCommand.SendRequest({object})) {
+			auto httpCode = deleteCommand.getResponseCode();
+			if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+				std::stringstream ss;
+				ss << "Failed to delete object " << object << "; response code "
+				   << httpCode << ": " << deleteCommand.getErrorMessage();
+				m_log.Log(XrdHTTPServer::Warning, "Unlink", ss.str().c_str());
+			}
+			return httpCode == 403 ? -EACCES : -EIO;
+		}
+		rv = harvestDelete(deleteCommand);
+		if (rv != 0) {
+			return rv;
+		}
+		S3BlockCache::Instance().Invalidate(statKey);
+		S3StatCache::Instance().Invalidate(statKey);
+		// The parent prefix's cached listing no longer reflects the bucket.
+		S3ListingCache::Instance().Invalidate(
+			statKey.substr(0, statKey.rfind('/') + 1));
+		return 0;
+	}
+	auto httpCode = headCommand.getResponseCode();
+	if (httpCode != 404) {
+		if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+			std::stringstream ss;
+			ss << "Failed to stat object " << object
+			   << " for deletion; response code " << httpCode;
+			m_log.Log(XrdHTTPServer::Warning, "Unlink", ss.str().c_str());
+		}
+		return httpCode == 403 ? -EACCES : -EIO;
+	}
+
+	// Not an object; try to remove the name as a pseudo-directory.
+	rv = deletePrefix(*ai, object + "/");
+	if (rv == 0) {
+		S3StatCache::Instance().Invalidate(statKey);
+		S3StatCache::Instance().Invalidate(statKey + "/");
+		S3ListingCache::Instance().Invalidate(
+			statKey.substr(0, statKey.rfind('/') + 1));
+	}
+	return rv;
+}
+
+int S3FileSystem::deletePrefix(const S3AccessInfo &ai,
+							   const std::string &prefix) {
+	const auto keyPrefix =
+		ai.getS3ServiceUrl() + "/" + ai.getS3BucketName() + "/";
+	std::string ct;
+	bool deletedAny = false;
+	bool morePages = true;
+	// The batch currently outstanding at the endpoint, if any.  Each
+	// DeleteObjects round trip is overlapped with the listing of the
+	// following page.
+	std::unique_ptr<AmazonS3DeleteObjects> inflight;
+	S3ListingCache::Instance().Invalidate(keyPrefix + prefix);
+	while (morePages) {
+		AmazonS3List listCommand(ai, prefix, AmazonS3DeleteObjects::m_max_keys,
+								 m_log);
+		if (!listCommand.SendRequest(ct)) {
+			auto httpCode = listCommand.getResponseCode();
+			if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+				std::stringstream ss;
+				ss << "Failed to list prefix " << prefix
+				   << " for deletion; response code " << httpCode << ": "
+				   << listCommand.getErrorMessage();
+				m_log.Log(XrdHTTPServer::Warning, "Unlink", ss.str().c_str());
+			}
+			if (inflight) {
+				harvestDelete(*inflight);
+			}
+			return httpCode == 403 ? -EACCES : -EIO;
+		}
+		std::vector<S3ObjectInfo> objInfo;
+		std::vector<std::string> commonPrefixes;
+		std::string errMsg;
+		ct.clear();
+		if (!listCommand.Results(objInfo, commonPrefixes, ct, errMsg)) {
+			m_log.Log(XrdHTTPServer::Warning, "Unlink",
+					  "Failed to parse S3 list response:", errMsg.c_str());
+			if (inflight) {
+				harvestDelete(*inflight);
+			}
+			return -EIO;
+		}
+		morePages = !ct.empty();
+
+		// Collect the previous batch's result before issuing the next one.
+		if (inflight) {
+			auto rv = harvestDelete(*inflight);
+			inflight.reset();
+			if (rv != 0) {
+				return rv;
+			}
+		}
+		if (!objInfo.empty()) {
+			std::vector<std::string> keys;
+			keys.reserve(objInfo.size());
+			for (const auto &obj : objInfo) {
+				keys.push_back(obj.m_key);
+				S3BlockCache::Instance().Invalidate(keyPrefix + obj.m_key);
+				S3StatCache::Instance().Invalidate(keyPrefix + obj.m_key);
+			}
+			inflight.reset(new AmazonS3DeleteObjects(ai, m_log));
+			if (!inflight->SendRequest(keys, false)) {
+				m_log.Log(XrdHTTPServer::Warning, "Unlink",
+						  "Failed to submit batch delete:",
+						  inflight->getErrorMessage().c_str());
+				return -EIO;
+			}
+			deletedAny = true;
+		}
+
+		// The listing uses a delimiter, so sub-directories come back as
+		// common prefixes; recurse into each.
+		for (const auto &subPrefix : commonPrefixes) {
+			auto rv = deletePrefix(ai, subPrefix);
+			if (rv == 0) {
+				deletedAny = true;
+			} else if (rv != -ENOENT) {
+				if (inflight) {
+					harvestDelete(*inflight);
+				}
+				return rv;
+			}
+		}
+	}
+	if (inflight) {
+		auto rv = harvestDelete(*inflight);
+		if (rv != 0) {
+			return rv;
+		}
+	}
+	return deletedAny ? 0 : -ENOENT;
+}
+
+int S3FileSystem::harvestDelete(AmazonS3DeleteObjects &deleteCommand) {
+	if (!deleteCommand.WaitForCompletion()) {
+		if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+			std::stringstream ss;
+			ss << "Batch delete failed with response code "
+			   << deleteCommand.getResponseCode() << ": "
+			   << deleteCommand.getErrorMessage();
+			m_log.Log(XrdHTTPServer::Warning, "Unlink", ss.str().c_str());
+		}
+		return deleteCommand.getResponseCode() == 403 ? -EACCES : -EIO;
+	}
+	std::vector<std::pair<std::string, std::string>> errors;
+	std::string errMsg;
+	if (!deleteCommand.Results(errors, errMsg)) {
+		m_log.Log(XrdHTTPServer::Warning, "Unlink",
+				  "Failed to parse S3 delete response:", errMsg.c_str());
+		return -EIO;
+	}
+	if (!errors.empty()) {
+		if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+			std::stringstream ss;
+			ss << "Endpoint failed to delete " << errors.size()
+			   << " object(s); first failure: " << errors.front().first << ": "
+			   << errors.front().second;
+			m_log.Log(XrdHTTPServer::Warning, "Unlink", ss.str().c_str());
+		}
+		return -EIO;
+	}
+	return 0;
+}
+
+int S3FileSystem::Rename(const char *oPath, const char *nPath,
+						 XrdOucEnv *oEnvP, XrdOucEnv *nEnvP) {
+	m_log.Log(XrdHTTPServer::Debug, "Rename", "Renaming path", oPath, nPath);
+
+	std::string srcExposed, srcObject, dstExposed, dstObject;
+	auto rv = parsePath(oPath, srcExposed, srcObject);
+	if (rv != 0) {
+		return rv;
+	}
+	rv = parsePath(nPath, dstExposed, dstObject);
+	if (rv != 0) {
+		return rv;
+	}
+	auto srcAi = getS3AccessInfo(srcExposed, srcObject);
+	auto dstAi = getS3AccessInfo(dstExposed, dstObject);
+	if (!srcAi || !dstAi) {
+		return -ENOENT;
+	}
+	if (srcAi->getS3BucketName().empty() || dstAi->getS3BucketName().empty()) {
+		return -EINVAL;
+	}
+	// The rename is done entirely as server-side copies, so both names
+	// must live at the same endpoint with the same credentials.
+	if (srcAi->getS3ServiceUrl() != dstAi->getS3ServiceUrl() ||
+		srcAi->getS3AccessKeyFile() != dstAi->getS3AccessKeyFile()) {
+		return -EXDEV;
+	}
+
+	trimslashes(srcObject);
+	trimslashes(dstObject);
+	if (srcObject.empty() || dstObject.empty()) {
+		return -EISDIR;
+	}
+
+	// The source's size determines whether a single CopyObject suffices
+	// or the range-parallel UploadPartCopy path is needed.
+	AmazonS3Head headCommand(*srcAi, srcObject, m_log);
+	if (!headCommand.SendRequest()) {
+		auto httpCode = headCommand.getResponseCode();
+		if (httpCode == 404) {
+			return -ENOENT;
+		}
+		if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+			std::stringstream ss;
+			ss << "Failed to stat object " << srcObject
+			   << " for rename; response code " << httpCode;
+			m_log.Log(XrdHTTPServer::Warning, "Rename", ss.str().c_str());
+		}
+		return httpCode == 403 ? -EACCES : -EIO;
+	}
+	const auto objSize = headCommand.getSize();
+
+	const auto copySource = srcAi->getS3BucketName() + "/" + srcObject;
+	if (static_cast<size_t>(objSize) <= m_part_size_max) {
+		AmazonS3CopyObject copyCommand(*dstAi, dstObject, m_log);
+		std::string errMsg;
+		if (!copyCommand.SendRequest(copySource) ||
+			!copyCommand.Results(errMsg)) {
+			auto httpCode = copyCommand.getResponseCode();
+			if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+				std::stringstream ss;
+				ss << "Failed to copy object " << srcObject << " to "
+				   << dstObject << "; response code " << httpCode << ": "
+				   << (errMsg.empty() ? copyCommand.getErrorMessage() : errMsg);
+				m_log.Log(XrdHTTPServer::Warning, "Rename", ss.str().c_str());
+			}
+			return httpCode == 403 ? -EACCES : -EIO;
+		}
+	} else {
+		// Objects beyond the single-request copy limit become a multipart
+		// upload at the destination whose parts are server-side copies of
+		// ranges of the source; several ranges are kept in flight on the
+		// worker pool at once.
+		AmazonS3CreateMultipartUpload startUpload(*dstAi, dstObject, m_log);
+		if (!startUpload.SendRequest()) {
+			m_log.Log(XrdHTTPServer::Warning, "Rename",
+					  "Failed to create multipart upload for rename:",
+					  startUpload.getErrorMessage().c_str());
+			return -EIO;
+		}
+		std::string uploadId, errMsg;
+		startUpload.Results(uploadId, errMsg);
+
+		// Rename uploads are not journaled, so a failure below would
+		// otherwise orphan the copied parts forever (accruing storage
+		// charges with no reaper to clean them up); abort the upload
+		// before surfacing the error.
+		auto abortUpload = [&]() {
+			AmazonS3AbortMultipartUpload abortCommand(*dstAi, dstObject,
+													  m_log);
+			if (!abortCommand.SendRequest(uploadId)) {
+				m_log.Log(XrdHTTPServer::Warning, "Rename",
+						  "Failed to abort multipart copy:",
+						  abortCommand.getErrorMessage().c_str());
+			}
+		};
+
+		// Same part sizing policy as uploads: aim for at most 1000 parts,
+		// clamped to the configured bounds.
+		constexpr size_t partTarget = 1000;
+		auto partSize =
+			(static_cast<size_t>(objSize) + partTarget - 1) / partTarget;
+		partSize =
+			std::min(std::max(partSize, m_part_size_min), m_part_size_max);
+
+		std::vector<std::string> eTags;
+		std::deque<std::unique_ptr<AmazonS3CopyPart>> inflight;
+		int partNumber = 1;
+		off_t offset = 0;
+		while (offset < objSize) {
+			auto copySize = std::min(static_cast<size_t>(objSize - offset),
+									 partSize);
+			inflight.emplace_back(
+				new AmazonS3CopyPart(*dstAi, dstObject, m_log));
+			if (!inflight.back()->SendRequest(copySource, offset, copySize,
+											  std::to_string(partNumber),
+											  uploadId, false)) {
+				m_log.Log(XrdHTTPServer::Warning, "Rename",
+						  "Failed to submit part copy:",
+						  inflight.back()->getErrorMessage().c_str());
+				// The request never made it to the worker pool; it must
+				// not be collected via WaitForCompletion.
+				inflight.pop_back();
+				while (!inflight.empty()) {
+					harvestCopyPart(*inflight.front(), eTags);
+					inflight.pop_front();
+				}
+				abortUpload();
+				return -EIO;
+			}
+			partNumber++;
+			offset += copySize;
+			while (inflight.size() >= m_part_pipeline_depth) {
+				rv = harvestCopyPart(*inflight.front(), eTags);
+				inflight.pop_front();
+				if (rv != 0) {
+					while (!inflight.empty()) {
+						harvestCopyPart(*inflight.front(), eTags);
+						inflight.pop_front();
+					}
+					abortUpload();
+					return rv;
+				}
+			}
+		}
+		while (!inflight.empty()) {
+			auto harvest_rv = harvestCopyPart(*inflight.front(), eTags);
+			inflight.pop_front();
+			if (harvest_rv != 0) {
+				rv = harvest_rv;
+			}
+		}
+		if (rv != 0) {
+			abortUpload();
+			return rv;
+		}
+
+		AmazonS3CompleteMultipartUpload completeCommand(*dstAi, dstObject,
+														m_log);
+		if (!completeCommand.SendRequest(eTags, partNumber, uploadId)) {
+			m_log.Log(XrdHTTPServer::Warning, "Rename",
+					  "Failed to complete multipart copy:",
+					  completeCommand.getErrorMessage().c_str());
+			abortUpload();
+			return -EIO;
+		}
+	}
+
+	// The copy landed; batch-delete the source object.
+	AmazonS3DeleteObjects deleteCommand(*srcAi, m_log);
+	if (!deleteCommand.SendRequest({srcObject})) {
+		m_log.Log(XrdHTTPServer::Warning, "Rename",
+				  "Failed to submit delete of rename source:",
+				  deleteCommand.getErrorMessage().c_str());
+		return -EIO;
+	}
+	rv = harvestDelete(deleteCommand);
+	if (rv != 0) {
+		return rv;
+	}
+
+	const auto srcKey =
+		srcAi->getS3ServiceUrl() + "/" + srcAi->getS3BucketName() + "/" +
+		srcObject;
+	const auto dstKey =
+		dstAi->getS3ServiceUrl() + "/" + dstAi->getS3BucketName() + "/" +
+		dstObject;
+	S3BlockCache::Instance().Invalidate(srcKey);
+	S3BlockCache::Instance().Invalidate(dstKey);
+	S3StatCache::Instance().Invalidate(srcKey);
+	S3StatCache::Instance().Invalidate(dstKey);
+	S3ListingCache::Instance().Invalidate(
+		srcKey.substr(0, srcKey.rfind('/') + 1));
+	S3ListingCache::Instance().Invalidate(
+		dstKey.substr(0, dstKey.rfind('/') + 1));
+	return 0;
+}
+
+int S3FileSystem::harvestCopyPart(AmazonS3CopyPart &copyCommand,
+								  std::vector<std::string> &eTags) {
+	if (!copyCommand.WaitForCompletion()) {
+		if (m_log.getMsgMask() & XrdHTTPServer::Warning) {
+			std::stringstream ss;
+			ss << "Part copy failed with response code "
+			   << copyCommand.getResponseCode() << ": "
+			   << copyCommand.getErrorMessage();
+			m_log.Log(XrdHTTPServer::Warning, "Rename", ss.str().c_str());
+		}
+		return copyCommand.getResponseCode() == 403 ? -EACCES : -EIO;
+	}
+	std::string etag, errMsg;
+	if (!copyCommand.GetEtag(etag, errMsg)) {
+		m_log.Log(XrdHTTPServer::Warning, "Rename",
+				  "Failed to parse S3 part copy response:", errMsg.c_str());
+		return -EIO;
+	}
+	eTags.push_back(etag);
+	return 0;
+}
+
 int S3FileSystem::Create(const char *tid, const char *path, mode_t mode,
 						 XrdOucEnv &env, int opts) {
 	// Is path valid?
@@ -434,42 +1298,163 @@ int S3FileSystem::Create(const char *tid, const char *path, mode_t mode,
 	return 0;
 }
 
+void S3FileSystem::buildExportIndex() {
+	m_export_root = ExportNode();
+	for (const auto &[exposedPath, info] : m_s3_access_map) {
+		ExportNode *node = &m_export_root;
+		std::string_view prefix(exposedPath);
+		size_t pos = 0;
+		while (pos < prefix.size()) {
+			while (pos < prefix.size() && prefix[pos] == '/') {
+				pos++;
+			}
+			if (pos == prefix.size()) {
+				break;
+			}
+			auto end = prefix.find('/', pos);
+			if (end == std::string_view::npos) {
+				end = prefix.size();
+			}
+			node = &node->m_children[std::string(prefix.substr(pos, end - pos))];
+			pos = end;
+		}
+		node->m_info = info;
+		node->m_exposedPath = exposedPath;
+	}
+}
+
+void S3FileSystem::PrewarmEndpoints(size_t connections) {
+	// One representative access info per distinct endpoint; several exports
+	// commonly front the same S3 service.
+	std::map<std::string, std::shared_ptr<S3AccessInfo>> endpoints;
+	for (const auto &entry : m_s3_access_map) {
+		endpoints.emplace(entry.second->getS3ServiceUrl(), entry.second);
+	}
+
+	// Dispatch every request before collecting any of them, so the
+	// handshakes run concurrently across the worker pool; a HEAD of the
+	// directory marker is cheap and its response (a 404 included) is
+	// irrelevant -- the point is the DNS resolution and TLS session the
+	// transfer leaves behind in the workers' connection caches.
+	std::vector<std::unique_ptr<AmazonS3Head>> inflight;
+	for (const auto &endpoint : endpoints) {
+		for (size_t idx = 0; idx < connections; idx++) {
+			inflight.emplace_back(
+				new AmazonS3Head(*endpoint.second, m_dir_marker_name, m_log));
+			if (!inflight.back()->SendRequest(false)) {
+				m_log.Log(XrdHTTPServer::Debug, "Prewarm",
+						  "Failed to submit endpoint pre-warm request:",
+						  inflight.back()->getErrorMessage().c_str());
+				inflight.pop_back();
+			}
+		}
+	}
+	for (const auto &request : inflight) {
+		request->WaitForCompletion();
+	}
+	if (m_log.getMsgMask() & XrdHTTPServer::Info) {
+		m_log.Log(XrdHTTPServer::Info, "Prewarm", "Pre-warmed",
+				  std::to_string(endpoints.size()).c_str(),
+				  "endpoint(s) for first-client requests");
+	}
+}
+
+void S3FileSystem::UploadReaperLoop(std::chrono::seconds age) {
+	// Sweep at most hourly; more frequent sweeps buy nothing for an
+	// age-based policy.
+	auto interval = std::min(age, std::chrono::seconds(3600));
+	while (true) {
+		std::this_thread::sleep_for(interval);
+		std::error_code ec;
+		std::filesystem::directory_iterator dir(UploadJournal::GetJournalDir(),
+												ec);
+		if (ec) {
+			continue;
+		}
+		for (const auto &entry : dir) {
+			std::error_code entry_ec;
+			auto mtime = std::filesystem::last_write_time(entry, entry_ec);
+			if (entry_ec) {
+				continue;
+			}
+			// Active uploads touch their entry with every completed part,
+			// so only genuinely abandoned uploads age out.
+			auto idle = decltype(mtime)::clock::now() - mtime;
+			if (idle < age) {
+				continue;
+			}
+			UploadJournal::State state;
+			if (UploadJournal::Parse(entry.path().string(), state) &&
+				exposedPathExists(state.m_exposedPath)) {
+				auto object = state.m_object;
+				auto ai = getS3AccessInfo(state.m_exposedPath, object);
+				if (ai && !ai->getS3BucketName().empty()) {
+					AmazonS3AbortMultipartUpload abortCommand(*ai, object,
+															  m_log);
+					if (!abortCommand.SendRequest(state.m_uploadId) &&
+						abortCommand.getResponseCode() != 404) {
+						// Endpoint unreachable (or similar); leave the
+						// entry for the next sweep.
+						m_log.Log(XrdHTTPServer::Warning, "UploadReaper",
+								  "Failed to abort orphaned multipart upload:",
+								  abortCommand.getErrorMessage().c_str());
+						continue;
+					}
+					m_log.Log(XrdHTTPServer::Info, "UploadReaper",
+							  "Aborted orphaned multipart upload for",
+							  state.m_object.c_str());
+				}
+			}
+			std::filesystem::remove(entry.path(), entry_ec);
+		}
+	}
+}
+
 int S3FileSystem::parsePath(const char *fullPath, std::string &exposedPath,
 							std::string &object) const {
 	//
-	// Check the path for validity.
+	// Walk the path's components down the export trie, remembering the
+	// deepest node that terminates a configured export; this resolves the
+	// longest matching prefix without allocating on the lookup.
 	//
-	std::filesystem::path p(fullPath);
-	auto pathComponents = p.begin();
-
-	// Iterate through components of the fullPath until we either find a match
-	// or we've reached the end of the path.
-	std::filesystem::path currentPath = *pathComponents;
-	while (pathComponents != p.end()) {
-		if (exposedPathExists(currentPath.string())) {
-			exposedPath = currentPath.string();
+	std::string_view path(fullPath);
+	const ExportNode *node = &m_export_root;
+	const ExportNode *best = node->m_info ? node : nullptr;
+	size_t pos = 0;
+	size_t bestEnd = 0;
+	while (pos < path.size()) {
+		while (pos < path.size() && path[pos] == '/') {
+			pos++;
+		}
+		if (pos == path.size()) {
 			break;
 		}
-		++pathComponents;
-		if (pathComponents != p.end()) {
-			currentPath /= *pathComponents;
-		} else {
-			return -ENOENT;
+		auto end = path.find('/', pos);
+		if (end == std::string_view::npos) {
+			end = path.size();
+		}
+		auto iter = node->m_children.find(path.substr(pos, end - pos));
+		if (iter == node->m_children.end()) {
+			break;
+		}
+		node = &iter->second;
+		pos = end;
+		if (node->m_info) {
+			best = node;
+			bestEnd = pos;
 		}
 	}
-
-	// Objects names may contain path separators.
-	++pathComponents;
-	if (pathComponents == p.end()) {
-		object = "";
-		return 0;
+	if (!best) {
+		return -ENOENT;
 	}
+	exposedPath = best->m_exposedPath;
 
-	std::filesystem::path objectPath = *pathComponents++;
-	for (; pathComponents != p.end(); ++pathComponents) {
-		objectPath /= (*pathComponents);
+	// Objects names may contain path separators.
+	pos = bestEnd;
+	while (pos < path.size() && path[pos] == '/') {
+		pos++;
 	}
-	object = objectPath.string();
+	object = path.substr(pos);
 
 	return 0;
 }
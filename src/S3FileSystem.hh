@@ -24,9 +24,15 @@
 #include <XrdSec/XrdSecEntity.hh>
 #include <XrdVersion.hh>
 
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
+
+class AmazonS3CopyPart;
+class AmazonS3DeleteObjects;
 
 class S3FileSystem : public XrdOss {
   public:
@@ -64,9 +70,7 @@ class S3FileSystem : public XrdOss {
 		return -ENOSYS;
 	}
 	int Rename(const char *oPath, const char *nPath, XrdOucEnv *oEnvP = 0,
-			   XrdOucEnv *nEnvP = 0) {
-		return -ENOSYS;
-	}
+			   XrdOucEnv *nEnvP = 0);
 	int Stat(const char *path, struct stat *buff, int opts = 0,
 			 XrdOucEnv *env = 0);
 	int Stats(char *buff, int blen) { return -ENOSYS; }
@@ -93,9 +97,7 @@ class S3FileSystem : public XrdOss {
 				 XrdOucEnv *env = 0) {
 		return -ENOSYS;
 	}
-	int Unlink(const char *path, int Opts = 0, XrdOucEnv *env = 0) {
-		return -ENOSYS;
-	}
+	int Unlink(const char *path, int Opts = 0, XrdOucEnv *env = 0);
 	int Lfn2Pfn(const char *Path, char *buff, int blen) { return -ENOSYS; }
 	const char *Lfn2Pfn(const char *Path, char *buff, int blen, int &rc) {
 		return nullptr;
@@ -134,6 +136,25 @@ class S3FileSystem : public XrdOss {
 	}
 	const std::string &getS3URLStyle() const { return s3_url_style; }
 
+	// Maximum number of multipart-upload parts a single file handle may keep
+	// in flight concurrently.
+	size_t getPartPipelineDepth() const { return m_part_pipeline_depth; }
+
+	// Maximum readahead depth, in blocks, for detected sequential reads;
+	// zero disables the readahead.
+	size_t getPrefetchBlocks() const { return m_prefetch_blocks; }
+
+	// Smallest part size used for multipart uploads; also the initial part
+	// size for streaming writes of unknown length.
+	size_t getPartSizeMin() const { return m_part_size_min; }
+
+	// Largest part size a multipart upload may scale up to.
+	size_t getPartSizeMax() const { return m_part_size_max; }
+
+	// Maximum number of concurrent sub-range GETs a single large
+	// cache-bypass read may be split into.
+	size_t getBypassStreams() const { return m_bypass_streams; }
+
 	const std::shared_ptr<S3AccessInfo>
 	getS3AccessInfo(const std::string &exposedPath, std::string &object) const;
 
@@ -153,6 +174,75 @@ class S3FileSystem : public XrdOss {
 
 	bool handle_required_config(const char *desired_name,
 								const std::string &source);
+
+	// Recursively delete every object under the given prefix, batching the
+	// keys into DeleteObjects requests and overlapping each batch with the
+	// next page of the listing.  Returns 0 if anything was deleted, -ENOENT
+	// if the prefix held no objects, or a negative errno on failure.
+	int deletePrefix(const S3AccessInfo &ai, const std::string &prefix);
+
+	// Wait for an outstanding batch delete to complete and surface any
+	// per-key failures it reports.
+	int harvestDelete(AmazonS3DeleteObjects &deleteCommand);
+
+	// Wait for an outstanding server-side part copy to complete, recording
+	// its ETag for the eventual completion request.
+	int harvestCopyPart(AmazonS3CopyPart &copyCommand,
+						std::vector<std::string> &eTags);
 	std::map<std::string, std::shared_ptr<S3AccessInfo>> m_s3_access_map;
+
+	// One node of the per-component trie used for longest-prefix export
+	// lookup.  The transparent comparator lets the hot path probe children
+	// with a std::string_view, so resolving a path allocates nothing.
+	struct ExportNode {
+		std::map<std::string, ExportNode, std::less<>> m_children;
+		// Access info for the export terminating at this node; unset for
+		// purely intermediate components.
+		std::shared_ptr<S3AccessInfo> m_info;
+		// The export's configured prefix, as keyed in m_s3_access_map.
+		std::string m_exposedPath;
+	};
+
+	// Rebuild the export lookup trie from m_s3_access_map; invoked once at
+	// the end of configuration.
+	void buildExportIndex();
+
+	// Body of the background thread that aborts journaled multipart
+	// uploads whose journal entry has not been touched within `age`.
+	void UploadReaperLoop(std::chrono::seconds age);
+
+	// Establish `connections` warm connections to each distinct configured
+	// endpoint on the curl worker pool, so the first clients after a
+	// restart do not all pay DNS resolution plus a TLS handshake at once.
+	// Runs once, on a background thread launched at configuration time.
+	void PrewarmEndpoints(size_t connections);
+
+	ExportNode m_export_root; // Root of the export lookup trie.
+
 	std::string s3_url_style;
+
+	// In-flight depth of the multipart upload write pipeline; configurable
+	// via `s3.part_pipeline_depth`.
+	size_t m_part_pipeline_depth{4};
+
+	// Maximum readahead depth, in blocks, for sequential streams;
+	// configurable via `s3.prefetch_blocks`.
+	size_t m_prefetch_blocks{16};
+
+	// Bounds on the per-object part size for multipart uploads; configurable
+	// via `s3.part_size_min` and `s3.part_size_max`.  The maximum defaults to
+	// S3's own 5GB limit on a single part.
+	size_t m_part_size_min{100'000'000};
+	size_t m_part_size_max{5'000'000'000};
+
+	// Maximum number of concurrent sub-range GETs for a large cache-bypass
+	// read; configurable via `s3.bypass_streams`.
+	size_t m_bypass_streams{8};
+
+	// Number of connections to pre-establish per configured endpoint at
+	// startup; configurable via `s3.prewarm_connections` (0 disables the
+	// pre-warm).  Each pre-warm request lands on one curl worker and warms
+	// that worker's connection cache, so a value matching the worker thread
+	// count warms the whole pool.
+	size_t m_prewarm_connections{2};
 };
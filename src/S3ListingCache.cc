@@ -0,0 +1,117 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "S3ListingCache.hh"
+
+// Default entry lifetime; overridden by the `s3.listing_cache_ttl`
+// configuration directive.
+std::atomic<time_t> S3ListingCache::m_ttl{10};
+
+// Default byte budget; overridden by the `s3.listing_cache_size`
+// configuration directive.
+std::atomic<size_t> S3ListingCache::m_max_bytes{64 * 1024 * 1024};
+
+size_t S3ListingCache::Listing::ApproxSize() const {
+	size_t result = sizeof(*this);
+	for (const auto &obj : m_objects) {
+		result += sizeof(obj) + obj.m_key.size();
+	}
+	for (const auto &prefix : m_common_prefixes) {
+		result += sizeof(prefix) + prefix.size();
+	}
+	return result;
+}
+
+S3ListingCache &S3ListingCache::Instance() {
+	static S3ListingCache instance;
+	return instance;
+}
+
+std::shared_ptr<const S3ListingCache::Listing>
+S3ListingCache::Get(const std::string &key) {
+	if (!m_ttl) {
+		return nullptr;
+	}
+
+	std::lock_guard lk(m_mutex);
+	auto iter = m_entries.find(key);
+	if (iter == m_entries.end()) {
+		return nullptr;
+	}
+	if (iter->second->m_expiry < std::chrono::steady_clock::now()) {
+		m_used_bytes -= iter->second->m_size;
+		m_lru.erase(iter->second);
+		m_entries.erase(iter);
+		return nullptr;
+	}
+	// Move the entry to the front of the LRU list.
+	m_lru.splice(m_lru.begin(), m_lru, iter->second);
+	return iter->second->m_listing;
+}
+
+void S3ListingCache::Put(const std::string &key,
+						 std::shared_ptr<const Listing> listing) {
+	if (!m_ttl || !listing) {
+		return;
+	}
+	auto size = listing->ApproxSize();
+	if (size > m_max_bytes / 2) {
+		// Too large to be worth the budget; a single huge listing would
+		// evict everything else.
+		return;
+	}
+
+	std::lock_guard lk(m_mutex);
+	auto expiry =
+		std::chrono::steady_clock::now() + std::chrono::seconds(m_ttl.load());
+	auto iter = m_entries.find(key);
+	if (iter != m_entries.end()) {
+		m_used_bytes -= iter->second->m_size;
+		iter->second->m_listing = std::move(listing);
+		iter->second->m_size = size;
+		iter->second->m_expiry = expiry;
+		m_used_bytes += size;
+		m_lru.splice(m_lru.begin(), m_lru, iter->second);
+		EvictExcess();
+		return;
+	}
+	m_lru.push_front(Entry{key, std::move(listing), size, expiry});
+	m_entries[key] = m_lru.begin();
+	m_used_bytes += size;
+	EvictExcess();
+}
+
+void S3ListingCache::Invalidate(const std::string &key) {
+	std::lock_guard lk(m_mutex);
+	auto iter = m_entries.find(key);
+	if (iter == m_entries.end()) {
+		return;
+	}
+	m_used_bytes -= iter->second->m_size;
+	m_lru.erase(iter->second);
+	m_entries.erase(iter);
+}
+
+void S3ListingCache::EvictExcess() {
+	while (m_used_bytes > m_max_bytes && !m_lru.empty()) {
+		auto &victim = m_lru.back();
+		m_used_bytes -= victim.m_size;
+		m_entries.erase(victim.m_key);
+		m_lru.pop_back();
+	}
+}
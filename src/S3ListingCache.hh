@@ -0,0 +1,112 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include "S3Commands.hh"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A process-wide, TTL-bounded cache of completed directory listings.
+//
+// Monitoring agents and XRootD's own stat-before-open behavior list the
+// same prefix repeatedly within seconds; without a cache every Opendir
+// restarts pagination from scratch.  Completed listings are stored as
+// shared, immutable objects so that concurrent open handles (and the
+// directory probe in `S3FileSystem::Stat`) serve from the same parsed
+// vectors without copying them.
+//
+// Entries are keyed by endpoint/bucket/prefix and evicted in
+// least-recently-used order once the configured byte budget is exceeded;
+// listings too large to be worth the budget are simply not cached.
+class S3ListingCache {
+  public:
+	// A completed listing of a prefix: every object and common prefix the
+	// pagination returned, in the order S3 handed them back.
+	struct Listing {
+		std::vector<S3ObjectInfo> m_objects;
+		std::vector<std::string> m_common_prefixes;
+
+		// Approximate memory footprint of the listing, used to charge the
+		// entry against the cache's byte budget.
+		size_t ApproxSize() const;
+	};
+
+	// Returns the singleton cache instance.
+	static S3ListingCache &Instance();
+
+	// Set the lifetime of a cache entry.  A TTL of 0 disables the cache
+	// entirely.  Invoked at config time, before any file I/O starts.
+	static void SetTTL(std::chrono::seconds ttl) { m_ttl = ttl.count(); }
+
+	static std::chrono::seconds GetTTL() {
+		return std::chrono::seconds(m_ttl.load());
+	}
+
+	// Set the maximum number of bytes of parsed listings kept cached.
+	static void SetCacheSize(size_t bytes) { m_max_bytes = bytes; }
+
+	static size_t GetCacheSize() { return m_max_bytes.load(); }
+
+	// Look up a completed listing for the given prefix.
+	//
+	// - `key`: Cache key for the prefix (endpoint, bucket and prefix).
+	// - Returns the shared listing on a hit, or nullptr.
+	std::shared_ptr<const Listing> Get(const std::string &key);
+
+	// Record a completed listing into the cache.  Listings larger than
+	// half the byte budget are ignored.
+	void Put(const std::string &key, std::shared_ptr<const Listing> listing);
+
+	// Drop any cached listing for the prefix; invoked when a write or
+	// unlink changes the prefix's contents.
+	void Invalidate(const std::string &key);
+
+  private:
+	S3ListingCache() = default;
+	S3ListingCache(const S3ListingCache &) = delete;
+
+	struct Entry {
+		std::string m_key;
+		std::shared_ptr<const Listing> m_listing;
+		size_t m_size{0};
+		std::chrono::steady_clock::time_point m_expiry;
+	};
+
+	// Evict LRU entries until the cache is within the byte budget.
+	// Caller must hold m_mutex.
+	void EvictExcess();
+
+	static std::atomic<time_t> m_ttl;
+	static std::atomic<size_t> m_max_bytes;
+
+	std::mutex m_mutex; // Protects the data structures below.
+	// Total approximate bytes currently charged to the cache.
+	size_t m_used_bytes{0};
+	// LRU ordering of the cached entries; front is most-recently-used.
+	std::list<Entry> m_lru;
+	// Lookup from the cache key to the entry's location in the LRU list.
+	std::unordered_map<std::string, std::list<Entry>::iterator> m_entries;
+};
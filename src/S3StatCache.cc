@@ -0,0 +1,91 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "S3StatCache.hh"
+
+// Default entry lifetime; overridden by the `s3.stat_cache_ttl`
+// configuration directive.
+std::atomic<time_t> S3StatCache::m_ttl{10};
+
+// Default entry capacity; overridden by the `s3.stat_cache_entries`
+// configuration directive.
+std::atomic<size_t> S3StatCache::m_max_entries{65536};
+
+S3StatCache &S3StatCache::Instance() {
+	static S3StatCache instance;
+	return instance;
+}
+
+bool S3StatCache::Get(const std::string &key, ObjectInfo &info) {
+	if (!m_ttl) {
+		return false;
+	}
+
+	std::lock_guard lk(m_mutex);
+	auto iter = m_entries.find(key);
+	if (iter == m_entries.end()) {
+		return false;
+	}
+	if (iter->second->m_expiry < std::chrono::steady_clock::now()) {
+		m_lru.erase(iter->second);
+		m_entries.erase(iter);
+		return false;
+	}
+	// Move the entry to the front of the LRU list.
+	m_lru.splice(m_lru.begin(), m_lru, iter->second);
+	info = iter->second->m_info;
+	return true;
+}
+
+void S3StatCache::Put(const std::string &key, const ObjectInfo &info) {
+	if (!m_ttl) {
+		return;
+	}
+
+	std::lock_guard lk(m_mutex);
+	auto expiry =
+		std::chrono::steady_clock::now() + std::chrono::seconds(m_ttl.load());
+	auto iter = m_entries.find(key);
+	if (iter != m_entries.end()) {
+		iter->second->m_info = info;
+		iter->second->m_expiry = expiry;
+		m_lru.splice(m_lru.begin(), m_lru, iter->second);
+		return;
+	}
+	m_lru.push_front(Entry{key, info, expiry});
+	m_entries[key] = m_lru.begin();
+	EvictExcess();
+}
+
+void S3StatCache::Invalidate(const std::string &key) {
+	std::lock_guard lk(m_mutex);
+	auto iter = m_entries.find(key);
+	if (iter == m_entries.end()) {
+		return;
+	}
+	m_lru.erase(iter->second);
+	m_entries.erase(iter);
+}
+
+void S3StatCache::EvictExcess() {
+	while (m_entries.size() > m_max_entries && !m_lru.empty()) {
+		auto &victim = m_lru.back();
+		m_entries.erase(victim.m_key);
+		m_lru.pop_back();
+	}
+}
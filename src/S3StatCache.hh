@@ -0,0 +1,103 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sys/types.h>
+
+// A process-wide, TTL-bounded cache of object metadata from HEAD results.
+//
+// A single client access typically costs several identical HEAD requests:
+// the redirector stats the path, then the open itself stats the object to
+// learn its size.  Both `S3FileSystem::Stat` and `S3File::Fstat` consult
+// this cache so only the first lookup within the TTL goes to the endpoint.
+//
+// Nonexistent objects are cached as negative entries (a recorded 404) so
+// that repeated lookups of missing paths do not each translate into a
+// billable S3 request.  Entries are keyed by endpoint/bucket/object and
+// evicted in least-recently-used order once the capacity is exceeded.
+class S3StatCache {
+  public:
+	// Cached metadata for a single object (or pseudo-directory).
+	struct ObjectInfo {
+		off_t m_size{0};
+		time_t m_last_modified{0};
+		// HTTP response code from the HEAD; 404 marks a negative entry.
+		unsigned long m_response_code{200};
+		// Set if the entry represents a pseudo-directory (common prefix).
+		bool m_is_directory{false};
+	};
+
+	// Returns the singleton cache instance.
+	static S3StatCache &Instance();
+
+	// Set the lifetime of a cache entry.  A TTL of 0 disables the cache
+	// entirely.  Invoked at config time, before any file I/O starts.
+	static void SetTTL(std::chrono::seconds ttl) { m_ttl = ttl.count(); }
+
+	static std::chrono::seconds GetTTL() {
+		return std::chrono::seconds(m_ttl.load());
+	}
+
+	// Set the maximum number of cached entries.
+	static void SetCapacity(size_t entries) { m_max_entries = entries; }
+
+	// Look up an object's metadata in the cache.
+	//
+	// - `key`: Cache key for the object (endpoint, bucket and object name).
+	// - `info`: Filled in with the cached metadata on a hit.
+	// - Returns true if a fresh entry was found, false otherwise.
+	bool Get(const std::string &key, ObjectInfo &info);
+
+	// Record a HEAD result (positive or negative) into the cache.
+	void Put(const std::string &key, const ObjectInfo &info);
+
+	// Drop any cached entry for the object; invoked when a write or unlink
+	// changes the object's existence or metadata.
+	void Invalidate(const std::string &key);
+
+  private:
+	S3StatCache() = default;
+	S3StatCache(const S3StatCache &) = delete;
+
+	struct Entry {
+		std::string m_key;
+		ObjectInfo m_info;
+		std::chrono::steady_clock::time_point m_expiry;
+	};
+
+	// Evict LRU entries until the cache is within capacity.  Caller must
+	// hold m_mutex.
+	void EvictExcess();
+
+	static std::atomic<time_t> m_ttl;
+	static std::atomic<size_t> m_max_entries;
+
+	std::mutex m_mutex; // Protects the data structures below.
+	// LRU ordering of the cached entries; front is most-recently-used.
+	std::list<Entry> m_lru;
+	// Lookup from the cache key to the entry's location in the LRU list.
+	std::unordered_map<std::string, std::list<Entry>::iterator> m_entries;
+};
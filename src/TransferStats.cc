@@ -0,0 +1,272 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "TransferStats.hh"
+#include "logging.hh"
+
+#include <XrdSys/XrdSysError.hh>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+using namespace XrdHTTPServer;
+
+namespace {
+
+// Escape a string for embedding in a JSON document.
+std::string jsonEscape(const std::string &str) {
+	std::string result;
+	result.reserve(str.size());
+	for (auto ch : str) {
+		switch (ch) {
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		default:
+			if (static_cast<unsigned char>(ch) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", ch);
+				result += buf;
+			} else {
+				result += ch;
+			}
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+TransferStats &TransferStats::Instance() {
+	static TransferStats instance;
+	return instance;
+}
+
+void TransferStats::RecordRequest(const std::string &endpoint,
+								  unsigned long responseCode, off_t bytesSent,
+								  off_t bytesRecv) {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	auto &entry = m_endpoints[endpoint];
+	entry.m_requests++;
+	entry.m_bytes_sent += bytesSent < 0 ? 0 : bytesSent;
+	entry.m_bytes_recv += bytesRecv < 0 ? 0 : bytesRecv;
+	entry.m_response_codes[responseCode]++;
+}
+
+void TransferStats::Histogram::Record(uint64_t value) {
+	size_t bucket = 0;
+	while (value > 1 && bucket < m_bucket_count - 1) {
+		value >>= 1;
+		bucket++;
+	}
+	m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TransferStats::RecordRequestTiming(const std::string &endpoint,
+										const RequestTiming &timing) {
+	EndpointTimings *entry;
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		entry = &m_timings[endpoint];
+	}
+	entry->m_namelookup_us.Record(
+		static_cast<uint64_t>(timing.m_namelookup * 1e6));
+	entry->m_appconnect_us.Record(
+		static_cast<uint64_t>(timing.m_appconnect * 1e6));
+	entry->m_starttransfer_us.Record(
+		static_cast<uint64_t>(timing.m_starttransfer * 1e6));
+	entry->m_total_us.Record(static_cast<uint64_t>(timing.m_total * 1e6));
+	entry->m_speed_download_bps.Record(timing.m_speed_download);
+	entry->m_speed_upload_bps.Record(timing.m_speed_upload);
+}
+
+void TransferStats::AddCacheStats(const CacheSample &sample) {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_cache_totals.m_hit_bytes += sample.m_hit_bytes;
+	m_cache_totals.m_miss_bytes += sample.m_miss_bytes;
+	m_cache_totals.m_full_hit_count += sample.m_full_hit_count;
+	m_cache_totals.m_partial_hit_count += sample.m_partial_hit_count;
+	m_cache_totals.m_miss_count += sample.m_miss_count;
+	m_cache_totals.m_bypass_bytes += sample.m_bypass_bytes;
+	m_cache_totals.m_bypass_count += sample.m_bypass_count;
+	m_cache_totals.m_fetch_bytes += sample.m_fetch_bytes;
+	m_cache_totals.m_fetch_count += sample.m_fetch_count;
+	m_cache_totals.m_unused_bytes += sample.m_unused_bytes;
+	m_cache_totals.m_prefetch_bytes += sample.m_prefetch_bytes;
+	m_cache_totals.m_prefetch_count += sample.m_prefetch_count;
+	m_cache_totals.m_errors += sample.m_errors;
+}
+
+void TransferStats::AddStatsSource(const std::string &name,
+								   std::function<std::string()> source) {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_extra_sources[name] = source;
+}
+
+std::string TransferStats::Summary() {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	uint64_t requests{0}, sent{0}, recv{0};
+	for (const auto &entry : m_endpoints) {
+		requests += entry.second.m_requests;
+		sent += entry.second.m_bytes_sent;
+		recv += entry.second.m_bytes_recv;
+	}
+	std::ostringstream ss;
+	ss << "requests=" << requests << " bytes_sent=" << sent
+	   << " bytes_recv=" << recv;
+	auto accessed = m_cache_totals.m_hit_bytes + m_cache_totals.m_miss_bytes;
+	if (accessed) {
+		ss << " cache_hit_rate=" << std::fixed << std::setprecision(1)
+		   << 100.0 * static_cast<double>(m_cache_totals.m_hit_bytes) /
+				  static_cast<double>(accessed)
+		   << "%";
+	}
+	if (m_cache_totals.m_errors) {
+		ss << " cache_errors=" << m_cache_totals.m_errors;
+	}
+	return ss.str();
+}
+
+std::string TransferStats::DumpJSON() {
+	std::lock_guard<std::mutex> lk(m_mutex);
+	std::ostringstream ss;
+	ss << "{\"endpoints\":{";
+	bool first_endpoint = true;
+	for (const auto &entry : m_endpoints) {
+		if (!first_endpoint) {
+			ss << ",";
+		}
+		first_endpoint = false;
+		ss << "\"" << jsonEscape(entry.first)
+		   << "\":{\"requests\":" << entry.second.m_requests
+		   << ",\"bytes_sent\":" << entry.second.m_bytes_sent
+		   << ",\"bytes_recv\":" << entry.second.m_bytes_recv
+		   << ",\"responses\":{";
+		bool first_code = true;
+		for (const auto &code : entry.second.m_response_codes) {
+			if (!first_code) {
+				ss << ",";
+			}
+			first_code = false;
+			ss << "\"" << code.first << "\":" << code.second;
+		}
+		ss << "}}";
+	}
+	// Serialize one histogram as an array of bucket counts, truncated after
+	// the last populated bucket to keep the dump compact.
+	auto dumpHistogram = [&ss](const char *name, const Histogram &histogram) {
+		size_t last = 0;
+		for (size_t idx = 0; idx < Histogram::m_bucket_count; idx++) {
+			if (histogram.m_buckets[idx].load(std::memory_order_relaxed)) {
+				last = idx + 1;
+			}
+		}
+		ss << "\"" << name << "\":[";
+		for (size_t idx = 0; idx < last; idx++) {
+			if (idx) {
+				ss << ",";
+			}
+			ss << histogram.m_buckets[idx].load(std::memory_order_relaxed);
+		}
+		ss << "]";
+	};
+	ss << "},\"timings\":{";
+	bool first_timing = true;
+	for (const auto &entry : m_timings) {
+		if (!first_timing) {
+			ss << ",";
+		}
+		first_timing = false;
+		ss << "\"" << jsonEscape(entry.first) << "\":{";
+		dumpHistogram("namelookup_us", entry.second.m_namelookup_us);
+		ss << ",";
+		dumpHistogram("appconnect_us", entry.second.m_appconnect_us);
+		ss << ",";
+		dumpHistogram("starttransfer_us", entry.second.m_starttransfer_us);
+		ss << ",";
+		dumpHistogram("total_us", entry.second.m_total_us);
+		ss << ",";
+		dumpHistogram("speed_download_bps", entry.second.m_speed_download_bps);
+		ss << ",";
+		dumpHistogram("speed_upload_bps", entry.second.m_speed_upload_bps);
+		ss << "}";
+	}
+	ss << "},\"cache\":{\"hit_bytes\":" << m_cache_totals.m_hit_bytes
+	   << ",\"miss_bytes\":" << m_cache_totals.m_miss_bytes
+	   << ",\"full_hit_count\":" << m_cache_totals.m_full_hit_count
+	   << ",\"partial_hit_count\":" << m_cache_totals.m_partial_hit_count
+	   << ",\"miss_count\":" << m_cache_totals.m_miss_count
+	   << ",\"bypass_bytes\":" << m_cache_totals.m_bypass_bytes
+	   << ",\"bypass_count\":" << m_cache_totals.m_bypass_count
+	   << ",\"fetch_bytes\":" << m_cache_totals.m_fetch_bytes
+	   << ",\"fetch_count\":" << m_cache_totals.m_fetch_count
+	   << ",\"unused_bytes\":" << m_cache_totals.m_unused_bytes
+	   << ",\"prefetch_bytes\":" << m_cache_totals.m_prefetch_bytes
+	   << ",\"prefetch_count\":" << m_cache_totals.m_prefetch_count
+	   << ",\"errors\":" << m_cache_totals.m_errors << "}";
+	for (const auto &source : m_extra_sources) {
+		ss << ",\"" << jsonEscape(source.first) << "\":" << source.second();
+	}
+	ss << "}";
+	return ss.str();
+}
+
+void TransferStats::LaunchStatsThread(XrdSysError &log,
+									  std::chrono::seconds interval,
+									  const std::string &jsonPath) {
+	std::call_once(m_launch, [&] {
+		std::thread t(&TransferStats::StatsLoop, this, &log, interval,
+					  jsonPath);
+		t.detach();
+	});
+}
+
+void TransferStats::StatsLoop(XrdSysError *log, std::chrono::seconds interval,
+							  std::string jsonPath) {
+	while (true) {
+		std::this_thread::sleep_for(interval);
+		log->Log(LogMask::Info, "Stats", Summary().c_str());
+		if (jsonPath.empty()) {
+			continue;
+		}
+		// Write to a temporary file and rename it into place so that
+		// scrapers never observe a partially-written document.
+		auto tmpPath = jsonPath + ".tmp";
+		{
+			std::ofstream of(tmpPath, std::ofstream::trunc);
+			if (!of.is_open()) {
+				log->Log(LogMask::Warning, "Stats",
+						 "Failed to open statistics file for write:",
+						 tmpPath.c_str());
+				continue;
+			}
+			of << DumpJSON() << "\n";
+		}
+		if (rename(tmpPath.c_str(), jsonPath.c_str()) == -1) {
+			log->Log(LogMask::Warning, "Stats",
+					 "Failed to move statistics file into place:",
+					 jsonPath.c_str());
+		}
+	}
+}
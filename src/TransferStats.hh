@@ -0,0 +1,158 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <sys/types.h>
+
+class XrdSysError;
+
+// Process-wide aggregation of transfer and cache statistics.
+//
+// Every completed HTTP request is recorded here, keyed by endpoint, along
+// with its response code and the bytes moved in each direction.  File
+// handles fold their cache counters into the totals as they are destroyed,
+// so long-lived open files only contribute once they close.
+//
+// The statistics can be summarized through the XrdSysError logger on a
+// periodic basis and dumped as JSON to a configured file for scraping.
+class TransferStats {
+  public:
+	// Returns the singleton statistics instance.
+	static TransferStats &Instance();
+
+	// Record a completed HTTP request against the given endpoint.
+	//
+	// - `endpoint`: scheme://host[:port] the request was sent to.
+	// - `responseCode`: HTTP response code; 0 if the request failed before
+	// a response was received.
+	// - `bytesSent`/`bytesRecv`: Bytes uploaded/downloaded by the request.
+	void RecordRequest(const std::string &endpoint, unsigned long responseCode,
+					   off_t bytesSent, off_t bytesRecv);
+
+	// The per-phase timing decomposition of one completed request, as
+	// harvested from the curl easy handle.
+	struct RequestTiming {
+		double m_namelookup{0};	   // Seconds spent in name resolution.
+		double m_appconnect{0};	   // Seconds until the TLS handshake finished.
+		double m_starttransfer{0}; // Seconds until the first response byte.
+		double m_total{0};		   // Total seconds for the request.
+		uint64_t m_speed_download{0}; // Average download speed, bytes/sec.
+		uint64_t m_speed_upload{0};	  // Average upload speed, bytes/sec.
+	};
+
+	// Fold one request's phase timings into the endpoint's histograms.
+	// The histogram buckets are atomic, so only the endpoint lookup itself
+	// takes the lock.
+	void RecordRequestTiming(const std::string &endpoint,
+							 const RequestTiming &timing);
+
+	// A snapshot of one file handle's cache counters.
+	struct CacheSample {
+		uint64_t m_hit_bytes{0};
+		uint64_t m_miss_bytes{0};
+		uint64_t m_full_hit_count{0};
+		uint64_t m_partial_hit_count{0};
+		uint64_t m_miss_count{0};
+		uint64_t m_bypass_bytes{0};
+		uint64_t m_bypass_count{0};
+		uint64_t m_fetch_bytes{0};
+		uint64_t m_fetch_count{0};
+		uint64_t m_unused_bytes{0};
+		uint64_t m_prefetch_bytes{0};
+		uint64_t m_prefetch_count{0};
+		uint64_t m_errors{0};
+	};
+
+	// Fold a file handle's cache counters into the process-wide totals.
+	void AddCacheStats(const CacheSample &sample);
+
+	// Register a callback that contributes an additional top-level object
+	// (e.g., plugin-specific cache statistics) to the JSON dump; the
+	// callback must return a valid JSON object.
+	void AddStatsSource(const std::string &name,
+						std::function<std::string()> source);
+
+	// One-line, human-readable summary of the current totals.
+	std::string Summary();
+
+	// All statistics, serialized as a JSON object.
+	std::string DumpJSON();
+
+	// Launch the periodic reporting thread (idempotent).  Every `interval`
+	// the thread logs the one-line summary; if `jsonPath` is non-empty, it
+	// additionally rewrites that file with the JSON dump.
+	void LaunchStatsThread(XrdSysError &log, std::chrono::seconds interval,
+						   const std::string &jsonPath);
+
+  private:
+	TransferStats() = default;
+	TransferStats(const TransferStats &) = delete;
+
+	// Body of the periodic reporting thread.
+	void StatsLoop(XrdSysError *log, std::chrono::seconds interval,
+				   std::string jsonPath);
+
+	// A lock-free histogram with power-of-two buckets; bucket `i` counts
+	// samples in [2^i, 2^(i+1)) of whatever unit the caller records.
+	// Samples beyond the last bucket are clamped into it.
+	struct Histogram {
+		static constexpr size_t m_bucket_count = 40;
+		std::array<std::atomic<uint64_t>, m_bucket_count> m_buckets{};
+		void Record(uint64_t value);
+	};
+
+	// Per-endpoint phase-timing histograms.  Latencies are recorded in
+	// microseconds, speeds in bytes per second.
+	struct EndpointTimings {
+		Histogram m_namelookup_us;
+		Histogram m_appconnect_us;
+		Histogram m_starttransfer_us;
+		Histogram m_total_us;
+		Histogram m_speed_download_bps;
+		Histogram m_speed_upload_bps;
+	};
+
+	// Per-endpoint request accounting.
+	struct EndpointStats {
+		uint64_t m_requests{0};
+		uint64_t m_bytes_sent{0};
+		uint64_t m_bytes_recv{0};
+		// Histogram of HTTP response codes (0 for failed requests).
+		std::map<unsigned long, uint64_t> m_response_codes;
+	};
+
+	std::mutex m_mutex; // Protects all the data below.
+	std::map<std::string, EndpointStats> m_endpoints;
+	// Timing histograms, keyed by endpoint.  The map itself is guarded by
+	// m_mutex but the nodes are stable, so recording threads update the
+	// histograms without holding it.
+	std::map<std::string, EndpointTimings> m_timings;
+	CacheSample m_cache_totals;
+	std::map<std::string, std::function<std::string()>> m_extra_sources;
+	std::once_flag m_launch; // Flag ensuring a single reporting thread.
+};
@@ -0,0 +1,143 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "UploadJournal.hh"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+std::string UploadJournal::m_journal_dir;
+
+void UploadJournal::SetJournalDir(const std::string &dir) {
+	m_journal_dir = dir;
+}
+
+const std::string &UploadJournal::GetJournalDir() { return m_journal_dir; }
+
+bool UploadJournal::Enabled() { return !m_journal_dir.empty(); }
+
+std::string UploadJournal::EntryPath(const std::string &exposedPath,
+									 const std::string &object) {
+	// The entry name is a hash of the object's identity; Load() verifies
+	// the identity recorded inside the entry, so a (vanishingly unlikely)
+	// collision degrades to a missed resume rather than a wrong one.
+	auto digest = std::hash<std::string>{}(exposedPath + "\n" + object);
+	std::ostringstream ss;
+	ss << std::hex << digest;
+	return m_journal_dir + "/" + ss.str() + ".journal";
+}
+
+void UploadJournal::Start(const std::string &exposedPath,
+						  const std::string &object,
+						  const std::string &uploadId) {
+	if (!Enabled()) {
+		return;
+	}
+	std::ofstream of(EntryPath(exposedPath, object), std::ofstream::trunc);
+	if (!of.is_open()) {
+		return;
+	}
+	of << "exposed " << exposedPath << "\n";
+	of << "object " << object << "\n";
+	of << "upload " << uploadId << "\n";
+}
+
+void UploadJournal::RecordPart(const std::string &exposedPath,
+							   const std::string &object, size_t partNumber,
+							   off_t committed, const std::string &eTag,
+							   const std::string &checksum) {
+	if (!Enabled()) {
+		return;
+	}
+	std::ofstream of(EntryPath(exposedPath, object), std::ofstream::app);
+	if (!of.is_open()) {
+		return;
+	}
+	of << "part " << partNumber << " " << committed << " " << eTag;
+	if (!checksum.empty()) {
+		of << " " << checksum;
+	}
+	of << "\n";
+}
+
+void UploadJournal::Finish(const std::string &exposedPath,
+						   const std::string &object) {
+	if (!Enabled()) {
+		return;
+	}
+	std::error_code ec;
+	std::filesystem::remove(EntryPath(exposedPath, object), ec);
+}
+
+bool UploadJournal::Load(const std::string &exposedPath,
+						 const std::string &object, State &state) {
+	if (!Enabled()) {
+		return false;
+	}
+	if (!Parse(EntryPath(exposedPath, object), state)) {
+		return false;
+	}
+	// With no completed parts there is nothing worth resuming.
+	return state.m_exposedPath == exposedPath && state.m_object == object &&
+		   !state.m_eTags.empty();
+}
+
+bool UploadJournal::Parse(const std::string &path, State &state) {
+	std::ifstream in(path);
+	if (!in.is_open()) {
+		return false;
+	}
+	state = State();
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream ss(line);
+		std::string keyword;
+		ss >> keyword;
+		if (keyword == "exposed") {
+			ss >> std::ws;
+			std::getline(ss, state.m_exposedPath);
+		} else if (keyword == "object") {
+			ss >> std::ws;
+			std::getline(ss, state.m_object);
+		} else if (keyword == "upload") {
+			ss >> state.m_uploadId;
+		} else if (keyword == "part") {
+			size_t partNumber{0};
+			off_t committed{0};
+			std::string eTag;
+			ss >> partNumber >> committed >> eTag;
+			// Parts must appear in order with no gaps; a torn append
+			// invalidates everything that follows it.
+			if (ss.fail() || partNumber != state.m_eTags.size() + 1) {
+				break;
+			}
+			// The trailing checksum is optional; entries written before
+			// checksums existed (or for unchecksummed parts) omit it.
+			std::string checksum;
+			ss >> checksum;
+			state.m_eTags.push_back(eTag);
+			state.m_checksums.push_back(checksum);
+			state.m_committed = committed;
+		}
+	}
+	// An entry with an uploadId but no parts is still meaningful: the
+	// reaper can abort it even though a resume would have nothing to use.
+	return !state.m_uploadId.empty();
+}
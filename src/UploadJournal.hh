@@ -0,0 +1,97 @@
+/***************************************************************
+ *
+ * Copyright (C) 2024, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+// Persistent journal of in-progress multipart uploads.
+//
+// When a client connection drops mid-upload, the uploadId and the ETags of
+// the already-uploaded parts are normally lost: the retry restarts the
+// object from byte zero while the orphaned parts sit in the bucket costing
+// storage.  Journaling the upload state to a small local directory lets an
+// append re-open resume from the last completed part, and lets a reaper
+// abort uploads nobody came back for.
+//
+// Each upload gets one append-only text file in the journal directory; the
+// entry is removed when the upload completes or is reaped.
+class UploadJournal {
+  public:
+	// State of one resumable upload, as recorded in its journal entry.
+	struct State {
+		std::string m_exposedPath; // Export prefix the file was opened under.
+		std::string m_object;	   // Object path within the export.
+		std::string m_uploadId;	   // Upload ID assigned by the endpoint.
+		std::vector<std::string> m_eTags; // ETags of the completed parts.
+		// Per-part CRC32C checksums (base64), index-aligned with m_eTags;
+		// entries are empty for parts uploaded without a checksum.
+		std::vector<std::string> m_checksums;
+		off_t m_committed{0}; // Bytes covered by the completed parts.
+	};
+
+	// Set the directory journal entries are kept in; an empty directory
+	// disables journaling.  Invoked at config time, before any file I/O
+	// starts.
+	static void SetJournalDir(const std::string &dir);
+
+	static const std::string &GetJournalDir();
+
+	static bool Enabled();
+
+	// Create the journal entry for a freshly-started multipart upload.
+	static void Start(const std::string &exposedPath,
+					  const std::string &object, const std::string &uploadId);
+
+	// Append one completed part to the upload's journal entry.
+	//
+	// - `partNumber`: 1-based number of the completed part.
+	// - `committed`: Total bytes covered by parts 1 through `partNumber`.
+	// - `eTag`: The part's ETag, as returned by the endpoint.
+	// - `checksum`: The part's base64 CRC32C checksum, as sent to the
+	// endpoint; empty when the part carried none.  Checksummed uploads
+	// must echo every part's checksum at completion, so a resume has to
+	// restore these alongside the ETags.
+	static void RecordPart(const std::string &exposedPath,
+						   const std::string &object, size_t partNumber,
+						   off_t committed, const std::string &eTag,
+						   const std::string &checksum);
+
+	// Remove the journal entry once the upload completes (or is aborted).
+	static void Finish(const std::string &exposedPath,
+					   const std::string &object);
+
+	// Load the journal entry for the given object, if one exists; returns
+	// false when there is no (valid) entry for it.
+	static bool Load(const std::string &exposedPath, const std::string &object,
+					 State &state);
+
+	// Parse a journal file directly; used by the orphaned-upload reaper,
+	// which walks the journal directory instead of knowing the objects.
+	static bool Parse(const std::string &path, State &state);
+
+  private:
+	// Path of the journal entry for the given object.
+	static std::string EntryPath(const std::string &exposedPath,
+								 const std::string &object);
+
+	static std::string m_journal_dir;
+};
@@ -21,19 +21,31 @@
 // meaning no internet connectivity is needed to run them.
 //
 
+#include "../src/BufferPool.hh"
+#include "../src/S3BlockCache.hh"
 #include "../src/S3Commands.hh"
 #include "../src/S3File.hh"
 #include "../src/S3FileSystem.hh"
+#include "../src/S3ListingCache.hh"
+#include "../src/S3StatCache.hh"
+#include "../src/TransferStats.hh"
+#include "../src/UploadJournal.hh"
 #include "s3_tests_common.hh"
 
+#include <XrdOuc/XrdOucCRC.hh>
 #include <XrdOuc/XrdOucEnv.hh>
+#include <XrdSfs/XrdSfsAio.hh>
+#include <XrdSys/XrdSysPageSize.hh>
 #include <XrdSys/XrdSysError.hh>
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
 #include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <thread>
 
 std::once_flag g_init_once;
@@ -162,6 +174,58 @@ s3.end
 		VerifyContents(fs, name, writeSize, chunkByte, chunkSize);
 	}
 
+	// Upload an object in fixed-size chunks, delivering each adjacent pair
+	// of chunks in swapped order to exercise the out-of-order reordering
+	// window in the write path.
+	void WritePatternUnordered(const std::string &name, const off_t writeSize,
+							   const unsigned char chunkByte,
+							   const size_t chunkSize, bool known_size) {
+		XrdSysLogger log;
+		S3FileSystem fs(&log, m_configfn.c_str(), nullptr);
+
+		std::unique_ptr<XrdOssDF> fh(fs.newFile());
+		ASSERT_TRUE(fh);
+
+		XrdOucEnv env;
+		if (known_size) {
+			env.Put("oss.asize", std::to_string(writeSize).c_str());
+		}
+		auto rv = fh->Open(name.c_str(), O_CREAT | O_WRONLY, 0755, env);
+		ASSERT_EQ(rv, 0);
+
+		// Build the in-order chunk list, then swap each adjacent pair to
+		// produce the delivery order.
+		struct Chunk {
+			off_t m_off;
+			size_t m_size;
+			unsigned char m_byte;
+		};
+		std::vector<Chunk> chunks;
+		off_t offset = 0;
+		auto curChunkByte = chunkByte;
+		while (offset < writeSize) {
+			auto len =
+				std::min(static_cast<off_t>(chunkSize), writeSize - offset);
+			chunks.push_back({offset, static_cast<size_t>(len), curChunkByte});
+			offset += len;
+			curChunkByte += 1;
+		}
+		for (size_t idx = 0; idx + 1 < chunks.size(); idx += 2) {
+			std::swap(chunks[idx], chunks[idx + 1]);
+		}
+
+		for (const auto &chunk : chunks) {
+			std::string writeBuffer(chunk.m_size, chunk.m_byte);
+			rv = fh->Write(writeBuffer.data(), chunk.m_off, chunk.m_size);
+			ASSERT_EQ(rv, static_cast<ssize_t>(chunk.m_size));
+		}
+
+		rv = fh->Close();
+		ASSERT_EQ(rv, 0);
+
+		VerifyContents(fs, name, writeSize, chunkByte, chunkSize);
+	}
+
 	void RandomRead(const std::string &name, unsigned char chunkByte,
 					size_t chunkSize,
 					std::chrono::steady_clock::duration testLength) {
@@ -303,6 +367,16 @@ TEST_F(FileSystemS3Fixture, UploadMultipleChunks) {
 				 (10'000 / 1'024) * 1'024 + 42, 'a', 1'024, false);
 }
 
+// Upload chunks whose adjacent pairs arrive in swapped order; the write path
+// must hold the early segments in its reordering window and send them to S3
+// in order.
+TEST_F(FileSystemS3Fixture, UploadUnordered) {
+	WritePatternUnordered("/test/write_unordered.txt", 10'000'000, 'a',
+						  1'000'000, true);
+	WritePatternUnordered("/test/write_unordered_stream.txt", 10'000'000, 'a',
+						  1'000'000, false);
+}
+
 // Upload across multiple parts, not aligned to partition.
 TEST_F(FileSystemS3Fixture, UploadLarge) {
 	WritePattern("/test/write_large_1.txt",
@@ -347,7 +421,6 @@ TEST_F(FileSystemS3Fixture, UploadMultiPartUnaligned) {
 // Ensure that uploads timeout if no action occurs.
 TEST_F(FileSystemS3Fixture, UploadStall) {
 	HTTPRequest::SetStallTimeout(std::chrono::milliseconds(200));
-	S3File::LaunchMonitorThread();
 
 	XrdSysLogger log;
 	S3FileSystem fs(&log, m_configfn.c_str(), nullptr);
@@ -477,10 +550,328 @@ TEST_F(FileSystemS3Fixture, InvalidObject) {
 	ASSERT_EQ(fs.Stat("/test/trailing/", &buf, 0, nullptr), -ENOENT);
 }
 
+// Check the shared block cache's lookup and eviction logic.
+TEST(S3BlockCache, PutGetEvict) {
+	auto &cache = S3BlockCache::Instance();
+	auto origSize = S3BlockCache::GetCacheSize();
+	S3BlockCache::SetCacheSize(2 * 4096);
+
+	ASSERT_EQ(cache.Get("https://example.com/bucket/obj", 0), nullptr);
+
+	auto blockA = std::make_shared<std::vector<char>>(4096, 'a');
+	cache.Put("https://example.com/bucket/obj", 0, blockA);
+	auto result = cache.Get("https://example.com/bucket/obj", 0);
+	ASSERT_NE(result, nullptr);
+	ASSERT_EQ(result->size(), 4096U);
+	ASSERT_EQ((*result)[0], 'a');
+
+	// Same offset in a different object is a separate block.
+	ASSERT_EQ(cache.Get("https://example.com/bucket/other", 0), nullptr);
+
+	// Overflowing the budget evicts the least-recently-used block.
+	auto blockB = std::make_shared<std::vector<char>>(4096, 'b');
+	cache.Put("https://example.com/bucket/obj", 4096, blockB);
+	auto blockC = std::make_shared<std::vector<char>>(4096, 'c');
+	cache.Put("https://example.com/bucket/obj", 8192, blockC);
+	ASSERT_EQ(cache.Get("https://example.com/bucket/obj", 0), nullptr);
+	ASSERT_NE(cache.Get("https://example.com/bucket/obj", 8192), nullptr);
+
+	S3BlockCache::SetCacheSize(origSize);
+}
+
+// Check that blocks evicted from the in-memory tier spill to the disk tier
+// and are promoted back into memory on a later lookup.
+TEST(S3BlockCache, DiskSpill) {
+	auto &cache = S3BlockCache::Instance();
+	auto origSize = S3BlockCache::GetCacheSize();
+	char dirTemplate[] = "/tmp/xrds3-disk-cache-XXXXXX";
+	auto dirName = mkdtemp(dirTemplate);
+	ASSERT_NE(dirName, nullptr);
+	S3BlockCache::SetDiskCache(dirName, 8 * 1024 * 1024);
+	S3BlockCache::SetCacheSize(2 * 4096);
+
+	auto blockA = std::make_shared<std::vector<char>>(4096, 'a');
+	cache.Put("https://example.com/bucket/spill", 0, blockA);
+	auto blockB = std::make_shared<std::vector<char>>(4096, 'b');
+	cache.Put("https://example.com/bucket/spill", 4096, blockB);
+	auto blockC = std::make_shared<std::vector<char>>(4096, 'c');
+	cache.Put("https://example.com/bucket/spill", 8192, blockC);
+
+	// The oldest block no longer fits in memory but should come back from
+	// the spill file.
+	auto result = cache.Get("https://example.com/bucket/spill", 0);
+	ASSERT_NE(result, nullptr);
+	ASSERT_EQ(result->size(), 4096U);
+	ASSERT_EQ((*result)[0], 'a');
+	ASSERT_GT(cache.m_disk_hit_count.load(), 0);
+
+	S3BlockCache::SetDiskCache("", 0);
+	S3BlockCache::SetCacheSize(origSize);
+}
+
+// Check that invalidating an object drops its blocks from both tiers while
+// leaving other objects' blocks alone.
+TEST(S3BlockCache, Invalidate) {
+	auto &cache = S3BlockCache::Instance();
+	auto origSize = S3BlockCache::GetCacheSize();
+	char dirTemplate[] = "/tmp/xrds3-disk-cache-XXXXXX";
+	auto dirName = mkdtemp(dirTemplate);
+	ASSERT_NE(dirName, nullptr);
+	S3BlockCache::SetDiskCache(dirName, 8 * 1024 * 1024);
+	S3BlockCache::SetCacheSize(2 * 4096);
+
+	// Two blocks of the target object -- one destined for the disk tier --
+	// plus one block of a bystander object.
+	auto blockA = std::make_shared<std::vector<char>>(4096, 'a');
+	cache.Put("https://example.com/bucket/stale", 0, blockA);
+	auto blockB = std::make_shared<std::vector<char>>(4096, 'b');
+	cache.Put("https://example.com/bucket/stale", 4096, blockB);
+	auto blockC = std::make_shared<std::vector<char>>(4096, 'c');
+	cache.Put("https://example.com/bucket/fresh", 0, blockC);
+
+	cache.Invalidate("https://example.com/bucket/stale");
+	ASSERT_EQ(cache.Get("https://example.com/bucket/stale", 0), nullptr);
+	ASSERT_EQ(cache.Get("https://example.com/bucket/stale", 4096), nullptr);
+	ASSERT_NE(cache.Get("https://example.com/bucket/fresh", 0), nullptr);
+
+	S3BlockCache::SetDiskCache("", 0);
+	S3BlockCache::SetCacheSize(origSize);
+}
+
 // Check out the logic of the overlap copy routine.
 std::tuple<off_t, size_t, off_t, size_t>
 OverlapCopy(off_t req_off, size_t req_size, char *req_buf, off_t cache_off,
 			size_t cache_size, char *cache_buf, size_t &used);
+TEST(SegmentedBuffer, AppendCopyOut) {
+	SegmentedBuffer buffer;
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(buffer.size(), 0U);
+
+	// Append enough data to span several pooled segments, with appends
+	// that straddle the segment boundaries.
+	std::string pattern;
+	size_t appendSize = BufferPool::m_segment_size / 2 + 1000;
+	for (char byte = 'a'; byte <= 'f'; byte++) {
+		pattern += std::string(appendSize, byte);
+		buffer.append(std::string(appendSize, byte));
+	}
+	ASSERT_EQ(buffer.size(), pattern.size());
+
+	// Whole-buffer copy.
+	std::string contents(buffer.size(), '\0');
+	ASSERT_EQ(buffer.copyOut(contents.data(), 0, contents.size()),
+			  contents.size());
+	ASSERT_EQ(contents, pattern);
+
+	// A copy that crosses a segment boundary.
+	std::string window(4096, '\0');
+	auto windowOff = BufferPool::m_segment_size - 2048;
+	ASSERT_EQ(buffer.copyOut(window.data(), windowOff, window.size()),
+			  window.size());
+	ASSERT_EQ(window, pattern.substr(windowOff, window.size()));
+
+	// Reads past the end are clipped.
+	ASSERT_EQ(buffer.copyOut(window.data(), buffer.size() - 100, 4096), 100U);
+	ASSERT_EQ(buffer.copyOut(window.data(), buffer.size(), 4096), 0U);
+
+	buffer.clear();
+	ASSERT_TRUE(buffer.empty());
+
+	// Segments released by clear() are recycled by the pool.
+	auto segment = BufferPool::Instance().Acquire();
+	ASSERT_EQ(segment.size(), BufferPool::m_segment_size);
+	BufferPool::Instance().Release(std::move(segment));
+}
+
+// Round-trip an upload's state through the persistent journal.
+TEST(UploadJournal, RoundTrip) {
+	char dirTemplate[] = "/tmp/xrds3-journal-XXXXXX";
+	auto dirName = mkdtemp(dirTemplate);
+	ASSERT_NE(dirName, nullptr);
+	UploadJournal::SetJournalDir(dirName);
+
+	UploadJournal::State state;
+	// No entry yet -- and an entry with no completed parts is not
+	// resumable either.
+	ASSERT_FALSE(UploadJournal::Load("/test", "journal.txt", state));
+	UploadJournal::Start("/test", "journal.txt", "upload-123");
+	ASSERT_FALSE(UploadJournal::Load("/test", "journal.txt", state));
+
+	UploadJournal::RecordPart("/test", "journal.txt", 1, 100'000'000,
+							  "etag-1", "AAAAAA==");
+	UploadJournal::RecordPart("/test", "journal.txt", 2, 200'000'000,
+							  "etag-2", "");
+	ASSERT_TRUE(UploadJournal::Load("/test", "journal.txt", state));
+	ASSERT_EQ(state.m_uploadId, "upload-123");
+	ASSERT_EQ(state.m_eTags.size(), 2U);
+	ASSERT_EQ(state.m_eTags[1], "etag-2");
+	// Checksums stay index-aligned with the ETags, including parts that
+	// carried none.
+	ASSERT_EQ(state.m_checksums.size(), 2U);
+	ASSERT_EQ(state.m_checksums[0], "AAAAAA==");
+	ASSERT_TRUE(state.m_checksums[1].empty());
+	ASSERT_EQ(state.m_committed, 200'000'000);
+
+	// A different object does not pick up the entry.
+	ASSERT_FALSE(UploadJournal::Load("/test", "other.txt", state));
+
+	UploadJournal::Finish("/test", "journal.txt");
+	ASSERT_FALSE(UploadJournal::Load("/test", "journal.txt", state));
+
+	UploadJournal::SetJournalDir("");
+}
+
+TEST(CacheSlabPool, AcquireRelease) {
+	auto slab = CacheSlabPool::Instance().Acquire();
+	ASSERT_FALSE(slab.empty());
+	ASSERT_NE(slab.data(), nullptr);
+	slab.data()[0] = 'x';
+	slab.data()[CacheSlabPool::m_slab_size - 1] = 'y';
+
+	// Moving the handle transfers ownership of the storage.
+	auto other = std::move(slab);
+	ASSERT_TRUE(slab.empty());
+	ASSERT_FALSE(other.empty());
+	ASSERT_EQ(other.data()[0], 'x');
+
+	// An explicit release empties the handle and recycles the slab.
+	other.Release();
+	ASSERT_TRUE(other.empty());
+	auto recycled = CacheSlabPool::Instance().Acquire();
+	ASSERT_FALSE(recycled.empty());
+}
+
+TEST(TransferStats, RecordAndDump) {
+	auto &stats = TransferStats::Instance();
+	// A host no other test talks to, so the totals here are deterministic.
+	stats.RecordRequest("https://stats.example.com", 200, 1024, 2048);
+	stats.RecordRequest("https://stats.example.com", 503, 0, 512);
+
+	TransferStats::CacheSample sample;
+	sample.m_hit_bytes = 4096;
+	sample.m_miss_bytes = 1024;
+	stats.AddCacheStats(sample);
+
+	stats.AddStatsSource("test_source", [] { return "{\"value\":42}"; });
+
+	auto json = stats.DumpJSON();
+	ASSERT_NE(json.find("\"https://stats.example.com\":{\"requests\":2,"
+						"\"bytes_sent\":1024,\"bytes_recv\":2560,"
+						"\"responses\":{\"200\":1,\"503\":1}}"),
+			  std::string::npos)
+		<< json;
+	ASSERT_NE(json.find("\"test_source\":{\"value\":42}"), std::string::npos)
+		<< json;
+
+	auto summary = stats.Summary();
+	ASSERT_NE(summary.find("cache_hit_rate="), std::string::npos) << summary;
+}
+
+TEST(S3StatCache, PutGetInvalidate) {
+	auto &cache = S3StatCache::Instance();
+	const std::string key = "https://example.com/bucket/statobj";
+
+	S3StatCache::ObjectInfo info;
+	ASSERT_FALSE(cache.Get(key, info));
+
+	info.m_size = 1024;
+	info.m_last_modified = 1700000000;
+	cache.Put(key, info);
+
+	S3StatCache::ObjectInfo result;
+	ASSERT_TRUE(cache.Get(key, result));
+	ASSERT_EQ(result.m_size, 1024);
+	ASSERT_EQ(result.m_last_modified, 1700000000);
+	ASSERT_EQ(result.m_response_code, 200UL);
+
+	// Negative entries record the 404.
+	S3StatCache::ObjectInfo negative;
+	negative.m_response_code = 404;
+	cache.Put(key + ".missing", negative);
+	ASSERT_TRUE(cache.Get(key + ".missing", result));
+	ASSERT_EQ(result.m_response_code, 404UL);
+
+	cache.Invalidate(key);
+	ASSERT_FALSE(cache.Get(key, result));
+
+	// A TTL of zero disables the cache entirely.
+	auto origTTL = S3StatCache::GetTTL();
+	S3StatCache::SetTTL(std::chrono::seconds(0));
+	ASSERT_FALSE(cache.Get(key + ".missing", result));
+	S3StatCache::SetTTL(origTTL);
+}
+
+TEST(S3ListingCache, PutGetInvalidate) {
+	auto &cache = S3ListingCache::Instance();
+	const std::string key = "https://example.com/bucket/listing/";
+
+	ASSERT_EQ(cache.Get(key), nullptr);
+
+	auto listing = std::make_shared<S3ListingCache::Listing>();
+	listing->m_objects.emplace_back(S3ObjectInfo{1024, "listing/obj1"});
+	listing->m_common_prefixes.emplace_back("listing/sub/");
+	cache.Put(key, listing);
+
+	auto result = cache.Get(key);
+	ASSERT_NE(result, nullptr);
+	// The cached listing is shared, not copied.
+	ASSERT_EQ(result.get(), listing.get());
+	ASSERT_EQ(result->m_objects.size(), 1U);
+	ASSERT_EQ(result->m_objects[0].m_key, "listing/obj1");
+	ASSERT_EQ(result->m_common_prefixes.size(), 1U);
+
+	cache.Invalidate(key);
+	ASSERT_EQ(cache.Get(key), nullptr);
+
+	// A TTL of zero disables the cache entirely.
+	cache.Put(key, listing);
+	auto origTTL = S3ListingCache::GetTTL();
+	S3ListingCache::SetTTL(std::chrono::seconds(0));
+	ASSERT_EQ(cache.Get(key), nullptr);
+	S3ListingCache::SetTTL(origTTL);
+	cache.Invalidate(key);
+}
+
+TEST_F(FileSystemS3Fixture, UnlinkRecursive) {
+	WritePattern("/test/unlink_dir/obj1", 1'024, 'a', 1'024, true);
+	WritePattern("/test/unlink_dir/obj2", 1'024, 'b', 1'024, true);
+	WritePattern("/test/unlink_dir/sub/obj3", 1'024, 'c', 1'024, true);
+
+	auto fs = GetFS();
+
+	// Single-object unlink.
+	ASSERT_EQ(fs->Unlink("/test/unlink_dir/obj1"), 0);
+	struct stat buf;
+	ASSERT_EQ(fs->Stat("/test/unlink_dir/obj1", &buf), -ENOENT);
+
+	// Recursive removal of the pseudo-directory, including the nested
+	// sub-directory.
+	ASSERT_EQ(fs->Unlink("/test/unlink_dir"), 0);
+	ASSERT_EQ(fs->Stat("/test/unlink_dir/obj2", &buf), -ENOENT);
+	ASSERT_EQ(fs->Stat("/test/unlink_dir/sub/obj3", &buf), -ENOENT);
+
+	// A second removal finds nothing left.
+	ASSERT_EQ(fs->Unlink("/test/unlink_dir"), -ENOENT);
+}
+
+TEST_F(FileSystemS3Fixture, Rename) {
+	WritePattern("/test/rename_src.txt", 10'000, 'a', 1'024, true);
+
+	auto fs = GetFS();
+
+	ASSERT_EQ(fs->Rename("/test/rename_src.txt", "/test/rename_dst.txt"), 0);
+
+	// The source is gone and the destination carries the contents.
+	struct stat buf;
+	ASSERT_EQ(fs->Stat("/test/rename_src.txt", &buf), -ENOENT);
+	ASSERT_EQ(fs->Stat("/test/rename_dst.txt", &buf), 0);
+	ASSERT_EQ(buf.st_size, 10'000);
+
+	// Renaming a missing object fails cleanly.
+	ASSERT_EQ(fs->Rename("/test/rename_src.txt", "/test/rename_dst2.txt"),
+			  -ENOENT);
+}
+
 TEST(OverlapCopy, Simple) {
 	std::string repeatA(4096, 'a');
 	std::string repeatB(4096, 'b');
@@ -584,6 +975,189 @@ TEST_F(FileSystemS3Fixture, StressGet) {
 	}
 }
 
+TEST_F(FileSystemS3Fixture, VectorRead) {
+	// Upload a file with a known pattern.
+	auto name = "/test/vector_read.txt";
+	WritePattern(name, 10'000'000, 'a', 1'000'000, true);
+
+	auto fs = GetFS();
+	std::unique_ptr<XrdOssDF> fh(fs->newFile());
+	ASSERT_TRUE(fh);
+
+	XrdOucEnv env;
+	ASSERT_EQ(fh->Open(name, O_RDONLY, 0, env), 0);
+
+	// Unsorted fragments; some adjacent (and hence will coalesce into a
+	// single ranged GET), others far apart.  Each fragment is contained
+	// within a single 1MB chunk of the written pattern.
+	std::vector<long long> offsets{9'500'000, 0, 4'096, 3'000'000,
+								   3'001'024, 1'000'000};
+	std::vector<int> sizes{1024, 4096, 1024, 1024, 512, 100};
+	std::vector<unsigned char> expected{'j', 'a', 'a', 'd', 'd', 'b'};
+	std::vector<std::string> buffers;
+	buffers.reserve(offsets.size());
+	std::vector<XrdOucIOVec> iovec;
+	ssize_t total = 0;
+	for (size_t idx = 0; idx < offsets.size(); idx++) {
+		buffers.emplace_back(sizes[idx], 'x');
+		iovec.emplace_back(
+			XrdOucIOVec{offsets[idx], sizes[idx], 0, buffers[idx].data()});
+		total += sizes[idx];
+	}
+	ASSERT_EQ(fh->ReadV(iovec.data(), iovec.size()), total);
+	for (size_t idx = 0; idx < offsets.size(); idx++) {
+		std::string correctContents(sizes[idx], expected[idx]);
+		ASSERT_EQ(buffers[idx], correctContents);
+	}
+
+	// A fragment extending past EOF fails the whole vector read.
+	std::string pastEof(1024, 'x');
+	XrdOucIOVec badFrag{9'999'500, 1024, 0, pastEof.data()};
+	ASSERT_EQ(fh->ReadV(&badFrag, 1), -ESPIPE);
+
+	ASSERT_EQ(fh->Close(), 0);
+}
+
+// A single read spanning several bypass stripes is split into concurrent
+// sub-range GETs, each landing directly in its slice of the buffer.
+TEST_F(FileSystemS3Fixture, StripedBypassRead) {
+	auto name = "/test/striped_bypass.txt";
+	WritePattern(name, 100'000'000, 'a', 1'000'000, true);
+
+	auto fs = GetFS();
+	std::unique_ptr<XrdOssDF> fh(fs->newFile());
+	ASSERT_TRUE(fh);
+
+	XrdOucEnv env;
+	ASSERT_EQ(fh->Open(name, O_RDONLY, 0, env), 0);
+
+	// 70MB in one call: more than one 64MB stripe, so the read is served
+	// by two concurrent ranged GETs.
+	off_t offset = 500'000;
+	size_t size = 70'000'000;
+	std::vector<char> buffer(size, 'x');
+	ASSERT_EQ(fh->Read(buffer.data(), offset, size),
+			  static_cast<ssize_t>(size));
+
+	// Verify the assembled buffer against the written pattern, one
+	// pattern chunk at a time.
+	size_t verified = 0;
+	while (verified < size) {
+		auto file_off = offset + static_cast<off_t>(verified);
+		auto expected = static_cast<unsigned char>('a' + file_off / 1'000'000);
+		auto chunk_remaining = static_cast<size_t>(1'000'000 - (file_off % 1'000'000));
+		auto len = std::min(chunk_remaining, size - verified);
+		std::string correct(len, expected);
+		ASSERT_EQ(memcmp(buffer.data() + verified, correct.data(), len), 0)
+			<< "Mismatch in stripe data at file offset " << file_off;
+		verified += len;
+	}
+
+	ASSERT_EQ(fh->Close(), 0);
+}
+
+TEST_F(FileSystemS3Fixture, PgRead) {
+	// Upload a file with a known pattern.
+	auto name = "/test/pgread.txt";
+	WritePattern(name, 10'000'000, 'a', 1'000'000, true);
+
+	auto fs = GetFS();
+	std::unique_ptr<XrdOssDF> fh(fs->newFile());
+	ASSERT_TRUE(fh);
+
+	XrdOucEnv env;
+	ASSERT_EQ(fh->Open(name, O_RDONLY, 0, env), 0);
+
+	// Read two pages' worth and verify both the contents and the per-page
+	// CRC32C vector against an independently-computed checksum.
+	std::string buffer(2 * XrdSys::PageSize, 'x');
+	std::vector<uint32_t> csvec(2);
+	ASSERT_EQ(fh->pgRead(buffer.data(), 0, buffer.size(), csvec.data(), 0),
+			  static_cast<ssize_t>(buffer.size()));
+	std::string correctContents(buffer.size(), 'a');
+	ASSERT_EQ(buffer, correctContents);
+	std::vector<uint32_t> expected(2);
+	XrdOucCRC::Calc32C(correctContents.data(), correctContents.size(),
+					   expected.data());
+	ASSERT_EQ(csvec, expected);
+
+	ASSERT_EQ(fh->Close(), 0);
+}
+
+// Minimal XrdSfsAio implementation signalling a condition variable once the
+// OSS layer completes the request.
+class SimpleAioRequest final : public XrdSfsAio {
+  public:
+	SimpleAioRequest(void *buffer, off_t offset, size_t size) {
+		sfsAio.aio_buf = buffer;
+		sfsAio.aio_offset = offset;
+		sfsAio.aio_nbytes = size;
+	}
+
+	void doneRead() override {
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_done = true;
+		m_cv.notify_one();
+	}
+	void doneWrite() override { doneRead(); }
+	void Recycle() override {}
+
+	// Block until the request completes and return its result.
+	ssize_t Wait() {
+		std::unique_lock<std::mutex> lk(m_mutex);
+		m_cv.wait(lk, [&] { return m_done; });
+		m_done = false;
+		return Result;
+	}
+
+  private:
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	bool m_done{false};
+};
+
+TEST_F(FileSystemS3Fixture, AsyncRead) {
+	// Upload a file with a known pattern.
+	auto name = "/test/async_read.txt";
+	WritePattern(name, 10'000'000, 'a', 1'000'000, true);
+
+	auto fs = GetFS();
+	std::unique_ptr<XrdOssDF> fh(fs->newFile());
+	ASSERT_TRUE(fh);
+
+	XrdOucEnv env;
+	ASSERT_EQ(fh->Open(name, O_RDONLY, 0, env), 0);
+
+	// A small read served through the cache entries.
+	std::string buffer(4096, 'x');
+	SimpleAioRequest aio(buffer.data(), 1'000'000, buffer.size());
+	ASSERT_EQ(fh->Read(&aio), 0);
+	ASSERT_EQ(aio.Wait(), static_cast<ssize_t>(buffer.size()));
+	ASSERT_EQ(buffer, std::string(buffer.size(), 'b'));
+
+	// A read spanning a cache-entry boundary is split into two sub-ranges.
+	std::string spanning(4096, 'x');
+	SimpleAioRequest aioSpan(spanning.data(), 2 * 1024 * 1024 - 2048,
+							 spanning.size());
+	ASSERT_EQ(fh->Read(&aioSpan), 0);
+	ASSERT_EQ(aioSpan.Wait(), static_cast<ssize_t>(spanning.size()));
+	ASSERT_EQ(spanning, std::string(spanning.size(), 'c'));
+
+	// A read crossing EOF is clamped to the object size.
+	std::string tail(4096, 'x');
+	SimpleAioRequest aioTail(tail.data(), 9'999'000, tail.size());
+	ASSERT_EQ(fh->Read(&aioTail), 0);
+	ASSERT_EQ(aioTail.Wait(), 1'000);
+	ASSERT_EQ(tail.substr(0, 1'000), std::string(1'000, 'j'));
+
+	// A read entirely past EOF completes immediately with zero bytes.
+	SimpleAioRequest aioEof(tail.data(), 10'000'000, tail.size());
+	ASSERT_EQ(fh->Read(&aioEof), 0);
+	ASSERT_EQ(aioEof.Wait(), 0);
+
+	ASSERT_EQ(fh->Close(), 0);
+}
+
 class AmazonS3SendMultipartPartLowercase : public AmazonS3SendMultipartPart {
   protected:
 	virtual void modifyResponse(std::string &resp) override {
@@ -628,6 +1202,47 @@ TEST_F(FileSystemS3Fixture, Etag) {
 	ASSERT_TRUE(complete_upload_request.SendRequest(eTags, 2, uploadId));
 }
 
+// End-to-end CRC32C integrity for a checksummed multipart upload: the part
+// checksum accumulated while the payload was buffered must be accepted by
+// the endpoint both on the part upload and in the completion request.
+TEST_F(FileSystemS3Fixture, UploadChecksum) {
+	// Determine the S3 info.
+	auto oss = GetFS();
+	std::string exposedPath, object;
+	std::string path = "/test/upload_checksum_test";
+	ASSERT_EQ(oss->parsePath(path.c_str(), exposedPath, object), 0);
+
+	auto ai = oss->getS3AccessInfo(exposedPath, object);
+	ASSERT_NE(ai.get(), nullptr);
+	ASSERT_NE(ai->getS3BucketName(), "");
+	ASSERT_NE(object, "");
+
+	// Start an upload with checksums declared.
+	XrdSysLogger log;
+	XrdSysError err(&log, "test");
+	AmazonS3CreateMultipartUpload startUpload(*ai, object, err);
+	ASSERT_TRUE(startUpload.SendRequest(true));
+	std::string uploadId, errMsg;
+	startUpload.Results(uploadId, errMsg);
+
+	// Upload a buffered part; its checksum accumulates during append().
+	AmazonS3SendMultipartPart upload_part_request(*ai, object, err);
+	SegmentedBuffer payload;
+	payload.append("aaaa");
+	ASSERT_TRUE(
+		upload_part_request.SendRequest(payload, std::to_string(1), uploadId));
+	std::string etag;
+	ASSERT_TRUE(upload_part_request.GetEtag(etag));
+	ASSERT_FALSE(upload_part_request.GetChecksum().empty());
+
+	// Finalize the object, echoing the part checksum back to the endpoint.
+	std::vector<std::string> eTags{etag};
+	std::vector<std::string> checksums{upload_part_request.GetChecksum()};
+	AmazonS3CompleteMultipartUpload complete_upload_request(*ai, object, err);
+	ASSERT_TRUE(
+		complete_upload_request.SendRequest(eTags, checksums, 2, uploadId));
+}
+
 int main(int argc, char **argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();